@@ -0,0 +1,218 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef _TTS_SPEECH_ID_INDEX_H_
+#define _TTS_SPEECH_ID_INDEX_H_
+
+#include <unordered_map>
+#include <functional>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <list>
+
+namespace TTS {
+
+// Bidirectional {client speech id <-> service speech id} index with O(1) lookups in
+// both directions. The index holds at most "capacity" entries, the oldest entry is
+// evicted to make room and entries older than "maxAge" (i.e. whose terminal event
+// never arrived) or whose service id is reused are dropped on the next insertion.
+class SpeechIdIndex {
+public:
+    using IdList = std::vector<std::pair<uint32_t, uint32_t>>;
+    using EvictionHandler = std::function<void (uint32_t clientid, uint32_t serviceid)>;
+
+    struct Counters {
+        uint64_t added;
+        uint64_t duplicates;
+        uint64_t removed;
+        uint64_t evicted;
+        uint64_t expired;
+        uint64_t misses;
+    };
+
+    SpeechIdIndex(size_t capacity = 1024, std::chrono::seconds maxAge = std::chrono::seconds(30 * 60)) :
+        m_capacity(capacity ? capacity : 1),
+        m_maxAge(maxAge),
+        m_counters() {
+    }
+
+    // Called (with the index locked) for the entries dropped by eviction / aging
+    void setEvictionHandler(EvictionHandler handler) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_evictionHandler = handler;
+    }
+
+    bool add(uint32_t clientid, uint32_t serviceid) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return insert(clientid, serviceid, Clock::now());
+    }
+
+    // Registers a list of {clientid, serviceid} under a single lock,
+    // returns the number of newly added client ids
+    size_t add(const IdList &ids) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t added = 0;
+        auto now = Clock::now();
+        for(auto &id : ids)
+            added += insert(id.first, id.second, now) ? 1 : 0;
+        return added;
+    }
+
+    uint32_t getServiceId(uint32_t clientid) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_byClientId.find(clientid);
+        if(it == m_byClientId.end()) {
+            ++m_counters.misses;
+            return 0;
+        }
+        return it->second->serviceid;
+    }
+
+    uint32_t getClientId(uint32_t serviceid) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_byServiceId.find(serviceid);
+        if(it == m_byServiceId.end()) {
+            ++m_counters.misses;
+            return 0;
+        }
+        return it->second->clientid;
+    }
+
+    uint32_t removeClientId(uint32_t clientid) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_byClientId.find(clientid);
+        if(it == m_byClientId.end()) {
+            ++m_counters.misses;
+            return 0;
+        }
+
+        uint32_t serviceid = it->second->serviceid;
+        erase(it->second);
+        ++m_counters.removed;
+        return serviceid;
+    }
+
+    uint32_t removeServiceId(uint32_t serviceid) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_byServiceId.find(serviceid);
+        if(it == m_byServiceId.end()) {
+            ++m_counters.misses;
+            return 0;
+        }
+
+        uint32_t clientid = it->second->clientid;
+        erase(it->second);
+        ++m_counters.removed;
+        return clientid;
+    }
+
+    bool empty() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.empty();
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+        m_byClientId.clear();
+        m_byServiceId.clear();
+    }
+
+    Counters counters() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_counters;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        uint32_t clientid;
+        uint32_t serviceid;
+        Clock::time_point added;
+    };
+    using EntryList = std::list<Entry>;
+
+    bool insert(uint32_t clientid, uint32_t serviceid, Clock::time_point now) {
+        if(m_byClientId.find(clientid) != m_byClientId.end()) {
+            ++m_counters.duplicates;
+            return false;
+        }
+
+        // A reused service id means the old speech is long gone
+        auto stale = m_byServiceId.find(serviceid);
+        if(stale != m_byServiceId.end()) {
+            evict(stale->second);
+            ++m_counters.expired;
+        }
+
+        // Entries are kept in insertion order, the oldest ones are at the front
+        while(!m_entries.empty() && now - m_entries.front().added > m_maxAge) {
+            evict();
+            ++m_counters.expired;
+        }
+
+        if(m_entries.size() >= m_capacity) {
+            evict();
+            ++m_counters.evicted;
+        }
+
+        m_entries.push_back({clientid, serviceid, now});
+        auto entry = std::prev(m_entries.end());
+        m_byClientId.emplace(clientid, entry);
+        m_byServiceId.emplace(serviceid, entry);
+        ++m_counters.added;
+        return true;
+    }
+
+    void evict() {
+        evict(m_entries.begin());
+    }
+
+    void evict(EntryList::iterator entry) {
+        Entry evicted = *entry;
+        erase(entry);
+        if(m_evictionHandler)
+            m_evictionHandler(evicted.clientid, evicted.serviceid);
+    }
+
+    void erase(EntryList::iterator entry) {
+        m_byClientId.erase(entry->clientid);
+        m_byServiceId.erase(entry->serviceid);
+        m_entries.erase(entry);
+    }
+
+    const size_t m_capacity;
+    const std::chrono::seconds m_maxAge;
+    EntryList m_entries;
+    std::unordered_map<uint32_t, EntryList::iterator> m_byClientId;
+    std::unordered_map<uint32_t, EntryList::iterator> m_byServiceId;
+    Counters m_counters;
+    EvictionHandler m_evictionHandler;
+    std::mutex m_mutex;
+};
+
+} // namespace TTS
+
+#endif //_TTS_SPEECH_ID_INDEX_H_
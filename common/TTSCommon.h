@@ -24,7 +24,7 @@ namespace TTS {
 enum ResourceAllocationPolicy {
     INVALID_POLICY = -1,
     RESERVATION, // Resource must be reserved before usage
-    PRIORITY,    // NOT IMPLEMENTED
+    PRIORITY,    // Resource goes to the highest priority app, preempting a lower priority holder
     OPEN         // Any client can use the resource without any prior reservation
 };
 
@@ -35,6 +35,12 @@ enum SpeechState {
     SPEECH_NOT_FOUND
 };
 
+enum SpeechPriority {
+    SPEECH_PRIORITY_LOW = 0, // Held back until the client has no speech pending at the service
+    SPEECH_PRIORITY_NORMAL,
+    SPEECH_PRIORITY_HIGH     // Cancels the lower priority speech in progress and goes ahead of the pending ones
+};
+
 enum ExtendedEvents {
     EXT_EVENT_WILL_SPEAK        = 1 << 0,
     EXT_EVENT_PAUSED            = 1 << 1,
@@ -59,6 +65,9 @@ enum TTS_Error {
     TTS_SESSION_NOT_ACTIVE,
     TTS_APP_NOT_FOUND,
     TTS_POLICY_VIOLATION,
+    TTS_SPEECH_DUPLICATE,
+    TTS_SPEECH_REPLACED,
+    TTS_SPEECH_EXPIRED,
     TTS_OBJECT_DESTROYED = 1010,
     TTS_SPEECH_NOT_FOUND,
 };
@@ -29,6 +29,7 @@
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <memory>
 
 using namespace std;
 
@@ -115,6 +116,10 @@ public:
     virtual void onSpeechComplete(uint32_t appId, uint32_t sessionId, SpeechData &sd) {
         TTSLOG_WARNING("AppId=%d, SessionId=%d, SpeechId=%d", appId, sessionId, sd.id);
     };
+
+    virtual void onSpeechExpired(uint32_t appId, uint32_t sessionId, uint32_t speechId) {
+        TTSLOG_WARNING("AppId=%d, SessionId=%d, SpeechId=%d", appId, sessionId, speechId);
+    };
 };
 
 struct AppInfo {
@@ -214,9 +219,19 @@ private:
 #define OPT_EXIT                21
 #define OPT_BLOCK_TILL_INPUT    22
 #define OPT_SLEEP               23
+#define OPT_SPEAK_ASYNC         24
+#define OPT_SPEAK_BATCH         25
+#define OPT_SET_CHUNKING        26
+#define OPT_SPEAK_FILE          27
+#define OPT_SET_DUPLICATES      28
+#define OPT_SPEAK_CHANNEL       29
+#define OPT_SPEAK_AHEAD         30
+#define OPT_SPEAK_DEADLINE      31
 
 int main(int argc, char *argv[]) {
     std::map<uint32_t, AppInfo*> appInfoMap;
+    // Streamed files are read until their speech ends
+    std::vector<std::unique_ptr<MappedTextSource>> textSources;
 
     TTSClient *client = TTSClient::create(new MyConnectionCallback);
     if(!client) {
@@ -266,6 +281,14 @@ int main(int argc, char *argv[]) {
                     cout << OPT_EXIT                << ".exit" << endl;
                     cout << OPT_BLOCK_TILL_INPUT    << ".dummyInput" << endl;
                     cout << OPT_SLEEP               << ".sleep" << endl;
+                    cout << OPT_SPEAK_ASYNC         << ".speakAsync" << endl;
+                    cout << OPT_SPEAK_BATCH         << ".speakBatch" << endl;
+                    cout << OPT_SET_CHUNKING        << ".setSpeechChunking" << endl;
+                    cout << OPT_SPEAK_FILE          << ".speakStream (file)" << endl;
+                    cout << OPT_SET_DUPLICATES      << ".setDuplicateSuppression" << endl;
+                    cout << OPT_SPEAK_CHANNEL       << ".speakOnChannel" << endl;
+                    cout << OPT_SPEAK_AHEAD         << ".setSpeakAhead" << endl;
+                    cout << OPT_SPEAK_DEADLINE      << ".speak (deadline)" << endl;
                     cout << "------------------------" << endl;
                 } else {
                     cout << endl;
@@ -281,7 +304,7 @@ int main(int argc, char *argv[]) {
                 cin.ignore();
                 counter = 1;
             }
-        } while(g_connectedToTTS && !(choice >= OPT_ENABLE_TTS && choice <= OPT_SLEEP));
+        } while(g_connectedToTTS && !(choice >= OPT_ENABLE_TTS && choice <= OPT_SPEAK_DEADLINE));
 
         bool res = 0;
         int sid = 0;
@@ -435,6 +458,48 @@ int main(int argc, char *argv[]) {
                 }
                 break;
 
+            case OPT_SPEAK_ASYNC:
+                stream.getInput(appid, "Enter app id : ");
+                if(appInfoMap.find(appid) != appInfoMap.end()) {
+                    sessionid = appInfoMap.find(appid)->second->m_sessionId;
+                    stream.getInput(secure, "Secure/Plain Transfer [0/1] : ");
+                    stream.getInput(sid, "Speech Id (int) : ");
+                    stream.getInput(stext, "Enter text to be spoken : ");
+                    sdata.secure = secure;
+                    sdata.id = sid;
+                    sdata.text = stext;
+                    error = client->speakAsync(sessionid, std::move(sdata), [](TTS_Error result, uint32_t speechId, uint32_t serviceSpeechId) {
+                        TTSLOG_WARNING("speakAsync completed, SpeechId=%d, ServiceSpeechId=%d, result=%d", speechId, serviceSpeechId, result);
+                    });
+                    validateReturn(error, 0);
+                } else {
+                    cout << "Session hasn't been created for app(" << appid << ")" << endl;
+                }
+                break;
+
+            case OPT_SPEAK_BATCH:
+                stream.getInput(appid, "Enter app id : ");
+                if(appInfoMap.find(appid) != appInfoMap.end()) {
+                    int count = 0;
+                    std::vector<SpeechData> batch;
+                    std::vector<TTS_Error> results;
+                    sessionid = appInfoMap.find(appid)->second->m_sessionId;
+                    stream.getInput(count, "Number of speeches : ");
+                    stream.getInput(sid, "First Speech Id (int) : ");
+                    for(int i = 0; i < count; i++) {
+                        stream.getInput(stext, "Enter text to be spoken : ");
+                        batch.push_back(SpeechData(sid + i));
+                        batch.back().text = stext;
+                    }
+                    error = client->speakBatch(sessionid, batch, results);
+                    for(uint32_t i = 0; i < results.size(); i++)
+                        cout << "SpeechId " << batch[i].id << " : " << (results[i] == TTS_OK ? "queued" : "failed") << endl;
+                    validateReturn(error, 100);
+                } else {
+                    cout << "Session hasn't been created for app(" << appid << ")" << endl;
+                }
+                break;
+
             case OPT_PAUSE:
                 stream.getInput(appid, "Enter app id : ");
                 if(appInfoMap.find(appid) != appInfoMap.end()) {
@@ -528,6 +593,115 @@ int main(int argc, char *argv[]) {
             stream.getInput(appid, "Enter delay (in secs) : ");
             sleep(appid);
             break;
+
+            case OPT_SET_CHUNKING:
+                stream.getInput(appid, "Enter app id : ");
+                if(appInfoMap.find(appid) != appInfoMap.end()) {
+                    bool chunked = true;
+                    stream.getInput(chunked, "Enter chunked speech [0/1] : ");
+                    sessionid = appInfoMap.find(appid)->second->m_sessionId;
+                    error = client->setSpeechChunking(sessionid, chunked);
+                    validateReturn(error, 0);
+                } else {
+                    cout << "Session hasn't been created for app(" << appid << ")" << endl;
+                }
+                break;
+
+            case OPT_SPEAK_FILE:
+                stream.getInput(appid, "Enter app id : ");
+                if(appInfoMap.find(appid) != appInfoMap.end()) {
+                    string path;
+                    sessionid = appInfoMap.find(appid)->second->m_sessionId;
+                    stream.getInput(sid, "Speech Id (int) : ");
+                    stream.getInput(path, "Enter the path of the text file : ");
+                    std::unique_ptr<MappedTextSource> source(new MappedTextSource(path));
+                    if(!source->isValid()) {
+                        cout << "Couldn't open " << path << endl;
+                        break;
+                    }
+                    sdata.id = sid;
+                    error = client->speakStream(sessionid, sdata, *source);
+                    if(error == TTS_OK)
+                        textSources.push_back(std::move(source));
+                    validateReturn(error, 100);
+                } else {
+                    cout << "Session hasn't been created for app(" << appid << ")" << endl;
+                }
+                break;
+
+            case OPT_SET_DUPLICATES:
+                stream.getInput(appid, "Enter app id : ");
+                if(appInfoMap.find(appid) != appInfoMap.end()) {
+                    int policy = 0;
+                    int window = 0;
+                    DuplicateStats stats;
+                    sessionid = appInfoMap.find(appid)->second->m_sessionId;
+                    if(client->getDuplicateStats(sessionid, stats) == TTS_OK)
+                        cout << "Checked " << stats.checked << ", dropped " << stats.dropped << ", merged " << stats.merged
+                            << ", outside window " << stats.outsideWindow << endl;
+                    stream.getInput(policy, "Enter duplicate policy [0-speak/1-drop/2-merge] : ");
+                    stream.getInput(window, "Enter window (ms) : ");
+                    error = client->setDuplicateSuppression(sessionid, (DuplicateSpeechPolicy)policy, window);
+                    validateReturn(error, 0);
+                } else {
+                    cout << "Session hasn't been created for app(" << appid << ")" << endl;
+                }
+                break;
+
+            case OPT_SPEAK_CHANNEL:
+                stream.getInput(appid, "Enter app id : ");
+                if(appInfoMap.find(appid) != appInfoMap.end()) {
+                    string channel;
+                    sessionid = appInfoMap.find(appid)->second->m_sessionId;
+                    stream.getInput(channel, "Enter channel : ");
+                    stream.getInput(sid, "Speech Id (int) : ");
+                    stream.getInput(stext, "Enter text to be spoken : ");
+                    sdata.id = sid;
+                    sdata.text = stext;
+                    error = client->speakOnChannel(sessionid, channel, std::move(sdata), [](TTS_Error result, uint32_t speechId, uint32_t serviceSpeechId) {
+                        TTSLOG_WARNING("speakOnChannel completed, SpeechId=%d, ServiceSpeechId=%d, result=%d", speechId, serviceSpeechId, result);
+                    });
+                    validateReturn(error, 0);
+                } else {
+                    cout << "Session hasn't been created for app(" << appid << ")" << endl;
+                }
+                break;
+
+            case OPT_SPEAK_AHEAD:
+                stream.getInput(appid, "Enter app id : ");
+                if(appInfoMap.find(appid) != appInfoMap.end()) {
+                    int depth = 0;
+                    std::vector<SpeechEstimate> estimates;
+                    sessionid = appInfoMap.find(appid)->second->m_sessionId;
+                    if(client->getSpeechEstimates(sessionid, estimates) == TTS_OK) {
+                        for(auto &estimate : estimates)
+                            cout << "SpeechId " << estimate.speechId << " : starts in " << estimate.startsInMs << "ms, lasts " << estimate.durationMs << "ms" << endl;
+                    }
+                    stream.getInput(depth, "Enter speeches to keep ahead (0 for all) : ");
+                    error = client->setSpeakAhead(sessionid, depth);
+                    validateReturn(error, 0);
+                } else {
+                    cout << "Session hasn't been created for app(" << appid << ")" << endl;
+                }
+                break;
+
+            case OPT_SPEAK_DEADLINE:
+                stream.getInput(appid, "Enter app id : ");
+                if(appInfoMap.find(appid) != appInfoMap.end()) {
+                    int ttl = 0;
+                    sessionid = appInfoMap.find(appid)->second->m_sessionId;
+                    stream.getInput(sid, "Speech Id (int) : ");
+                    stream.getInput(stext, "Enter text to be spoken : ");
+                    stream.getInput(ttl, "Start within (ms) : ");
+                    SpeechData data(sid);
+                    data.text = stext;
+                    data.expireIn(std::chrono::milliseconds(ttl));
+                    error = client->speak(sessionid, data);
+                    validateReturn(error, 100);
+                } else {
+                    cout << "Session hasn't been created for app(" << appid << ")" << endl;
+                }
+                break;
         }
     }
 
@@ -0,0 +1,246 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "TTSClient.h"
+#include "logger.h"
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <getopt.h>
+
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
+
+// --- //
+
+#define MAX_THREAD_COUNT 32
+
+// --- //
+
+using namespace TTS;
+
+volatile bool g_connectedToTTS = false;
+
+std::condition_variable g_condition;
+std::mutex g_mutex;
+GMainLoop* g_loop;
+
+class MyConnectionCallback : public TTSConnectionCallback {
+public:
+    virtual void onTTSServerConnected() {
+        TTSLOG_INFO("Connection to TTSManager got established");
+        g_connectedToTTS = true;
+        g_condition.notify_one();
+    }
+
+    virtual void onTTSServerClosed() {
+        TTSLOG_ERROR("Connection to TTSManager got closed");
+        g_connectedToTTS = false;
+    }
+};
+
+class MySessionCallback : public TTSSessionCallback {
+public:
+    virtual void onTTSSessionCreated(uint32_t appId, uint32_t sessionId) {
+        TTSLOG_INFO("AppId=%d, SessionId=%d", appId, sessionId);
+    }
+};
+
+struct ThreadData {
+public:
+    ThreadData() :
+        threadCount(4),
+        callCount(100),
+        speak(0),
+        client(NULL),
+        sessionId(0) {
+        }
+
+    int threadCount;
+    int callCount;
+    int speak;
+    TTSClient *client;
+    uint32_t sessionId;
+};
+
+// Every iteration issues independent calls, which should overlap on the link
+// when made from several threads instead of being serialized
+int CallerFunc(ThreadData &td, int index) {
+    int failures = 0;
+    SpeechData sd;
+    SpeechState state;
+
+    for(int i = 0; i < td.callCount; i++) {
+        td.client->isTTSEnabled(true);
+        td.client->isSpeaking(td.sessionId, true);
+        if(td.client->getSpeechState(td.sessionId, index, state, true) == TTS_FAIL)
+            ++failures;
+
+        if(td.speak) {
+            sd.id = index * td.callCount + i;
+            sd.text = "Concurrency test";
+            if(td.client->speak(td.sessionId, sd) != TTS_OK)
+                ++failures;
+        }
+    }
+
+    return failures;
+}
+
+double RunTest(ThreadData &td, int threadCount, int &failures) {
+    std::vector<std::thread> threads;
+    std::vector<int> results(threadCount, 0);
+
+    auto start = std::chrono::steady_clock::now();
+    for(int t = 0; t < threadCount; t++)
+        threads.emplace_back([&td, &results, t]() { results[t] = CallerFunc(td, t); });
+
+    for(auto &thread : threads)
+        thread.join();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    failures = 0;
+    for(int f : results)
+        failures += f;
+
+    int calls = threadCount * td.callCount * (td.speak ? 4 : 3);
+    return elapsed > 0 ? calls / elapsed : 0;
+}
+
+void ThreadFunc(void *data) {
+    ThreadData &td = *(ThreadData*)data;
+
+    td.client = TTSClient::create(new MyConnectionCallback);
+
+    // Wait for the client to be connected to TTSEngine
+    auto c_timeout = std::chrono::system_clock::now() + std::chrono::seconds(10);
+    while(!g_connectedToTTS && std::chrono::system_clock::now() < c_timeout) {
+        TTSLOG_WARNING("Waiting for TTS Manager connection");
+        std::unique_lock<std::mutex> lock(g_mutex);
+        g_condition.wait_until(lock, c_timeout, []() { return g_connectedToTTS; });
+    }
+
+    if(!g_connectedToTTS) {
+        TTSLOG_ERROR("Cound't connect to TTS Manager, exiting...");
+        delete td.client;
+        g_main_loop_quit(g_loop);
+        return;
+    }
+
+    td.client->enableTTS();
+    td.sessionId = td.client->createSession(1, "WPE", new MySessionCallback);
+
+    int failures = 0;
+    double serial = RunTest(td, 1, failures);
+    printf("1 thread   : %10.1f calls/s, %d failures\n", serial, failures);
+
+    double concurrent = RunTest(td, td.threadCount, failures);
+    printf("%-2d threads : %10.1f calls/s, %d failures\n", td.threadCount, concurrent, failures);
+    if(serial > 0)
+        printf("Speedup    : %10.2fx\n", concurrent / serial);
+
+    td.client->abort(td.sessionId, true);
+    td.client->destroySession(td.sessionId);
+    delete td.client;
+    td.client = NULL;
+
+    g_main_loop_quit(g_loop);
+}
+
+int main(int argc, char *argv[]) {
+    /* start the gmain loop */
+    g_loop = g_main_loop_new(g_main_context_default(), FALSE);
+
+    if(argc > 1 && strcmp(argv[1], "--help") == 0) {
+        printf(\
+        " \n\
+        Usage : \n\
+        * %s [--threads <n>] [--calls <calls_per_thread>] [--speak]\n\
+        \n", argv[0]);
+
+        return 0;
+    }
+
+    ThreadData td;
+    static struct option long_options[] =
+    {
+        {"threads",         required_argument, 0, 't'},
+        {"calls",           required_argument, 0, 'n'},
+
+        {"speak",           no_argument, &td.speak, 1},
+
+        {0, 0, 0, 0}
+    };
+
+    while (1)
+    {
+        /* getopt_long stores the option index here. */
+        int option_index = 0;
+
+        int c = getopt_long (argc, argv, "t:n:",
+                long_options, &option_index);
+
+        /* Check if none of the given options selected to break the loop */
+        if (c == -1)
+            break;
+
+        switch (c)
+        {
+            case 0:
+                /* Don't do anything and continue to check other input options */
+                break;
+
+            case 't':
+                td.threadCount = atoi(optarg);
+                if(td.threadCount <= 0)
+                    td.threadCount = 1;
+                if(td.threadCount > MAX_THREAD_COUNT)
+                    td.threadCount = MAX_THREAD_COUNT;
+                break;
+
+            case 'n':
+                td.callCount = atoi(optarg);
+                if(td.callCount <= 0)
+                    td.callCount = 1;
+                break;
+
+            case '?':
+                /* getopt_long already printed an error message. */
+                break;
+
+            default:
+                abort ();
+        }
+    }
+
+    printf("Thread Count=%d, Calls per Thread=%d, Speak=%d\n", td.threadCount, td.callCount, td.speak);
+
+    new std::thread(ThreadFunc, &td);
+
+    g_main_loop_run(g_loop);
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+// Exercises the hand-over of the resource between the apps of the process against
+// a fake backend, no service is needed. The arbiter's policy is read once per process,
+// so the test is run once with TTS_CLIENT_RESOURCE_POLICY=reservation and once with
+// TTS_CLIENT_RESOURCE_POLICY=priority.
+
+#include "ResourceArbiter.h"
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+using namespace TTS;
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if(!(cond)) { \
+        printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while(0)
+
+// --- //
+
+// Records the speeches cancelled, the service ids are handed out from 1
+struct FakeBackend {
+    FakeBackend() : nextId(1) {}
+
+    SessionTable::Submitter submitter() {
+        return [this](SpeechData &, uint32_t &serviceid) {
+            serviceid = nextId++;
+            return TTS_OK;
+        };
+    }
+
+    SessionTable::Canceller canceller() {
+        return [this](uint32_t serviceid) {
+            cancelled.push_back(serviceid);
+            return true;
+        };
+    }
+
+    uint32_t nextId;
+    std::vector<uint32_t> cancelled;
+};
+
+struct Recorder : public TTSSessionCallback {
+    void onResourceAcquired(uint32_t appId, uint32_t) override { events.push_back("acquired " + std::to_string(appId)); }
+    void onResourceReleased(uint32_t appId, uint32_t) override { events.push_back("released " + std::to_string(appId)); }
+
+    std::vector<std::string> events;
+};
+
+// --- //
+
+// The claimer takes the resource from its holder, which gets it back on release
+static void testReservation() {
+    FakeBackend backend;
+    SessionTable first(backend.submitter(), backend.canceller());
+    SessionTable second(backend.submitter(), backend.canceller());
+    Recorder recorder;
+    SessionTable::SessionPtr a = first.create(10, "a", &recorder);
+    SessionTable::SessionPtr b = second.create(20, "b", &recorder);
+    ResourceArbiter &arbiter = ResourceArbiter::Instance();
+
+    SpeechData data(1);
+    data.text = "text";
+    uint32_t serviceid = 0;
+    CHECK(first.speak(a, data, &serviceid) == TTS_RESOURCE_BUSY);
+    CHECK(arbiter.acquire(30) == TTS_APP_NOT_FOUND);
+    CHECK(arbiter.acquire(10) == TTS_OK);
+    CHECK(arbiter.acquire(20) == TTS_RESOURCE_BUSY);
+    CHECK(first.speak(a, data, &serviceid) == TTS_OK && serviceid == 1);
+    CHECK(second.speak(b, data, &serviceid) == TTS_RESOURCE_BUSY);
+
+    // The holder's speeches are cancelled by the claim
+    CHECK(arbiter.claim(20) == TTS_OK);
+    CHECK(arbiter.claim(10) == TTS_NESTED_CLAIM_REQUEST);
+    CHECK(!arbiter.isActive(10) && arbiter.isActive(20));
+    CHECK((backend.cancelled == std::vector<uint32_t>{1}));
+    CHECK(second.speak(b, data, &serviceid) == TTS_OK);
+    CHECK(arbiter.release(20) == TTS_OK);
+    CHECK(arbiter.isActive(10));
+
+    // The resource is released with the holder's last session, which isn't notified
+    first.destroy(a->id);
+    CHECK(!arbiter.isActive(10));
+    CHECK(arbiter.acquire(20) == TTS_OK);
+    CHECK(arbiter.release(20) == TTS_OK);
+    CHECK((recorder.events == std::vector<std::string>{"acquired 10", "released 10", "acquired 20", "released 20",
+        "acquired 10", "acquired 20", "released 20"}));
+}
+
+// A higher priority app preempts the holder, whose speeches are cancelled, and the
+// waiting apps are served by priority
+static void testPriority() {
+    FakeBackend backend;
+    SessionTable table(backend.submitter(), backend.canceller());
+    Recorder recorder;
+    SessionTable::SessionPtr a = table.create(10, "a", &recorder);
+    SessionTable::SessionPtr b = table.create(20, "b", &recorder);
+    SessionTable::SessionPtr c = table.create(30, "c", &recorder);
+    a->resourcePriority = 1;
+    b->resourcePriority = 5;
+    c->resourcePriority = 1;
+    ResourceArbiter &arbiter = ResourceArbiter::Instance();
+
+    SpeechData data(1);
+    data.text = "text";
+    uint32_t serviceid = 0;
+    CHECK(arbiter.acquire(10) == TTS_OK);
+    CHECK(table.speak(a, data, &serviceid) == TTS_OK && serviceid == 1);
+    CHECK(arbiter.acquire(30) == TTS_RESOURCE_BUSY);    // queued
+    CHECK(arbiter.claim(30) == TTS_POLICY_VIOLATION);
+
+    CHECK(arbiter.acquire(20) == TTS_OK);
+    CHECK(!arbiter.isActive(10) && arbiter.isActive(20));
+    CHECK((backend.cancelled == std::vector<uint32_t>{1}));
+
+    // The preempted holder is ahead of the apps which queued after it got the resource
+    CHECK(arbiter.release(20) == TTS_OK);
+    CHECK(arbiter.isActive(10));
+    CHECK(arbiter.release(10) == TTS_OK);
+    CHECK(arbiter.isActive(30));
+    CHECK(arbiter.release(30) == TTS_OK);
+    CHECK((recorder.events == std::vector<std::string>{"acquired 10", "released 10", "acquired 20", "released 20",
+        "acquired 10", "released 10", "acquired 30", "released 30"}));
+
+    ResourceStats stats = arbiter.stats();
+    CHECK(stats.granted == 4 && stats.preempted == 1 && stats.queued == 1 && stats.rejected == 0);
+}
+
+int main() {
+    switch(ResourceArbiter::Instance().policy()) {
+    case RESERVATION:
+        testReservation();
+        break;
+    case PRIORITY:
+        testPriority();
+        break;
+    default:
+        printf("Set TTS_CLIENT_RESOURCE_POLICY to reservation or priority\n");
+        return 1;
+    }
+
+    if(failures)
+        printf("%d check(s) failed\n", failures);
+    else
+        printf("All checks passed\n");
+    return failures ? 1 : 0;
+}
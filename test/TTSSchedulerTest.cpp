@@ -0,0 +1,559 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+// Exercises the client side speech scheduling of SessionTable against a fake
+// backend, no service is needed. Run with the "open" resource policy.
+
+#include "SessionTable.h"
+#include "AsyncSpeechQueue.h"
+
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TTS;
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if(!(cond)) { \
+        printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while(0)
+
+// --- //
+
+// Records the speeches submitted & cancelled, the service ids are handed out from 100.
+// The streamed speeches are submitted from the library's threads, hence the mutex
+struct FakeBackend {
+    FakeBackend() : nextId(100) {}
+
+    SessionTable::Submitter submitter() {
+        return [this](SpeechData &data, uint32_t &serviceid) {
+            std::lock_guard<std::mutex> lock(mutex);
+            serviceid = nextId++;
+            submitted.push_back(data.text);
+            return TTS_OK;
+        };
+    }
+
+    SessionTable::Canceller canceller() {
+        return [this](uint32_t serviceid) {
+            std::lock_guard<std::mutex> lock(mutex);
+            cancelled.push_back(serviceid);
+            return true;
+        };
+    }
+
+    uint32_t nextId;
+    std::vector<std::string> submitted;     // indexed by service id - 100
+    std::vector<uint32_t> cancelled;
+    std::mutex mutex;
+};
+
+struct Recorder : public TTSSessionCallback {
+    void onSpeechStart(uint32_t, uint32_t, SpeechData &data) override { record("start " + std::to_string(data.id)); }
+    void onSpeechCancelled(uint32_t, uint32_t, uint32_t speechId) override { record("cancel " + std::to_string(speechId)); }
+    void onSpeechInterrupted(uint32_t, uint32_t, uint32_t speechId) override { record("interrupt " + std::to_string(speechId)); }
+    void onSpeechComplete(uint32_t, uint32_t, SpeechData &data) override { record("complete " + std::to_string(data.id)); }
+    void onSpeechExpired(uint32_t, uint32_t, uint32_t speechId) override { record("expired " + std::to_string(speechId)); }
+
+    void record(const std::string &event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push_back(event);
+    }
+
+    std::vector<std::string> events;
+    std::mutex mutex;
+};
+
+// Polls "condition" under "mutex" for up to WAIT_TIMEOUT_MS, for the work done on the library's threads
+#define WAIT_TIMEOUT_MS 2000
+
+template<typename Condition>
+static bool waitFor(std::mutex &mutex, Condition condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(WAIT_TIMEOUT_MS);
+    while(1) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(condition())
+                return true;
+        }
+        if(std::chrono::steady_clock::now() >= deadline)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+static SpeechData speech(uint32_t id, const std::string &text, SpeechPriority priority = SPEECH_PRIORITY_NORMAL) {
+    SpeechData data(id);
+    data.text = text;
+    data.priority = priority;
+    return data;
+}
+
+// --- //
+
+static void testPriorities() {
+    FakeBackend backend;
+    SessionTable table(backend.submitter(), backend.canceller());
+    Recorder recorder;
+    SessionTable::SessionPtr session = table.create(1, "scheduler", &recorder);
+
+    uint32_t serviceid = 0;
+    SpeechData a = speech(1, "a");
+    SpeechData low = speech(2, "low", SPEECH_PRIORITY_LOW);
+    SpeechData b = speech(3, "b");
+    SpeechData c = speech(4, "c");
+    SpeechData high = speech(5, "high", SPEECH_PRIORITY_HIGH);
+
+    CHECK(table.speak(session, a, &serviceid) == TTS_OK && serviceid == 100);
+    CHECK(table.speak(session, low, &serviceid) == TTS_OK && serviceid == 0);   // held back
+    CHECK(table.speak(session, b, &serviceid) == TTS_OK && serviceid == 101);
+    CHECK(table.speak(session, c, &serviceid) == TTS_OK && serviceid == 102);
+    table.dispatch(SessionTable::SpeechStart, 100);
+
+    // Interrupts "a", withdraws "b" & "c" and submits them again behind "high"
+    CHECK(table.speak(session, high, &serviceid) == TTS_OK && serviceid == 103);
+    CHECK((backend.submitted == std::vector<std::string>{"a", "b", "c", "high", "b", "c"}));
+    CHECK((backend.cancelled == std::vector<uint32_t>{101, 102, 100}));
+
+    table.dispatch(SessionTable::SpeechCancel, 101);    // withdrawn, not reported
+    table.dispatch(SessionTable::SpeechCancel, 100);
+    table.dispatch(SessionTable::SpeechComplete, 103);
+    table.dispatch(SessionTable::SpeechComplete, 104);
+    CHECK(backend.submitted.size() == 6);
+
+    // The low priority speech goes once nothing else is pending
+    table.dispatch(SessionTable::SpeechComplete, 105);
+    CHECK(backend.submitted.size() == 7 && backend.submitted.back() == "low");
+    table.dispatch(SessionTable::SpeechComplete, 106);
+    CHECK((recorder.events == std::vector<std::string>{"start 1", "cancel 1", "complete 5", "complete 3", "complete 4", "complete 2"}));
+
+    SpeechData d = speech(6, "d");
+    SpeechData held = speech(7, "held", SPEECH_PRIORITY_LOW);
+    table.speak(session, d, &serviceid);
+    table.speak(session, held, &serviceid);
+    table.clearHeld(session);
+    CHECK(recorder.events.back() == "cancel 7");
+}
+
+// The speeches of a preemptive session are high priority, they interrupt the normal
+// ones of the other sessions
+static void testPreemptive() {
+    FakeBackend backend;
+    SessionTable table(backend.submitter(), backend.canceller());
+    Recorder recorder, urgent;
+    SessionTable::SessionPtr session = table.create(1, "normal", &recorder);
+    SessionTable::SessionPtr preemptive = table.create(2, "preemptive", &urgent);
+    preemptive->preemptive = true;
+
+    uint32_t serviceid = 0;
+    SpeechData a = speech(1, "a");
+    SpeechData b = speech(1, "b");
+    CHECK(table.speak(session, a, &serviceid) == TTS_OK && serviceid == 100);
+    table.dispatch(SessionTable::SpeechStart, 100);
+    CHECK(table.speak(preemptive, b, &serviceid) == TTS_OK && serviceid == 101);
+    CHECK((backend.cancelled == std::vector<uint32_t>{100}));
+
+    table.dispatch(SessionTable::SpeechInterrupt, 100);
+    table.dispatch(SessionTable::SpeechStart, 101);
+    table.dispatch(SessionTable::SpeechComplete, 101);
+    CHECK((recorder.events == std::vector<std::string>{"start 1", "interrupt 1"}));
+    CHECK((urgent.events == std::vector<std::string>{"start 1", "complete 1"}));
+}
+
+static void testChunks() {
+    FakeBackend backend;
+    SessionTable table(backend.submitter(), backend.canceller());
+    Recorder recorder;
+    SessionTable::SessionPtr session = table.create(1, "chunks", &recorder);
+    session->chunked = true;
+
+    uint32_t serviceid = 0;
+    const std::string first = "The first sentence is long enough.";
+    const std::string second = "Short one. The last sentence ends the text.";
+    SpeechData text = speech(1, first + "  " + second);
+    CHECK(table.speak(session, text, &serviceid) == TTS_OK && serviceid == 100);
+    CHECK((backend.submitted == std::vector<std::string>{first}));
+
+    // The next chunk is queued once the previous one starts, the app sees one speech
+    table.dispatch(SessionTable::SpeechStart, 100);
+    CHECK((backend.submitted == std::vector<std::string>{first, second}));
+    table.dispatch(SessionTable::SpeechComplete, 100);
+    table.dispatch(SessionTable::SpeechStart, 101);
+    table.dispatch(SessionTable::SpeechComplete, 101);
+    CHECK((recorder.events == std::vector<std::string>{"start 1", "complete 1"}));
+
+    // A short tail stays with its sentence, markup is never cut
+    SpeechData tail = speech(2, "A sentence which is long enough. Tiny tail.");
+    SpeechData ssml = speech(3, "<speak>The first sentence is long enough. And so is the second one.</speak>");
+    table.speak(session, tail, &serviceid);
+    table.speak(session, ssml, &serviceid);
+    CHECK(backend.submitted.size() == 4 && backend.submitted[2] == tail.text && backend.submitted[3] == ssml.text);
+
+    // Clauses are cut only once long
+    const std::string clause = "This clause goes on and on, well past the length at which long clauses are cut up,";
+    const std::string rest = "and then it ends with no sentence at all";
+    SpeechData clauses = speech(4, clause + " " + rest);
+    table.speak(session, clauses, &serviceid);
+    CHECK(backend.submitted.size() == 5 && backend.submitted[4] == clause);
+}
+
+// The text without its spacing, the chunks are trimmed
+static std::string squeeze(const std::string &text) {
+    std::string squeezed;
+    for(char c : text)
+        if(c != ' ')
+            squeezed += c;
+    return squeezed;
+}
+
+// Hands out one sentence per read, counting the reads
+struct SentenceSource {
+    SentenceSource(size_t count) : reads(0), next(0), count(count) {}
+
+    static std::string sentence(size_t i) { return "This is sentence number " + std::to_string(i) + " of a long document. "; }
+
+    std::string text() const {
+        std::string text;
+        for(size_t i = 0; i < count; i++)
+            text += sentence(i);
+        return text;
+    }
+
+    IteratorTextSource source() {
+        return IteratorTextSource([this](std::string &segment) {
+            reads++;
+            if(next >= count)
+                return false;
+            segment = sentence(next++);
+            return true;
+        });
+    }
+
+    std::atomic<size_t> reads;
+    size_t next;
+    const size_t count;
+};
+
+static void testStream() {
+    FakeBackend backend;
+    SessionTable table(backend.submitter(), backend.canceller());
+    Recorder recorder;
+    SessionTable::SessionPtr session = table.create(1, "stream", &recorder);
+
+    // The source is read a chunk ahead of the one submitted, not to its end
+    SentenceSource sentences(50);
+    IteratorTextSource source = sentences.source();
+    SpeechData data(1);
+    CHECK(table.speakStream(session, data, source) == TTS_OK);
+    CHECK(waitFor(backend.mutex, [&] { return backend.submitted.size() == 1; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(sentences.reads < 10);
+    {
+        std::lock_guard<std::mutex> lock(backend.mutex);
+        CHECK(backend.submitted.size() == 1);
+    }
+
+    // Each chunk is submitted as its predecessor starts, until the text is over
+    auto complete = [&] {
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        return !recorder.events.empty() && recorder.events.back() == "complete 1";
+    };
+    for(uint32_t serviceid = 100; !complete(); serviceid++) {
+        size_t index = serviceid - 100;
+        if(!waitFor(backend.mutex, [&] { return backend.submitted.size() > index || complete(); }) || complete())
+            break;
+        table.dispatch(SessionTable::SpeechStart, serviceid);
+        table.dispatch(SessionTable::SpeechComplete, serviceid);
+    }
+    CHECK(complete());
+
+    std::string spoken;
+    for(auto &chunk : backend.submitted)
+        spoken += chunk;
+    CHECK(squeeze(spoken) == squeeze(sentences.text()));
+    CHECK((recorder.events == std::vector<std::string>{"start 1", "complete 1"}));
+
+    // The end of a chunk ends the stream, the source isn't read any more
+    SentenceSource cancelled(50);
+    IteratorTextSource other = cancelled.source();
+    SpeechData stopped(2);
+    size_t first = backend.submitted.size();
+    CHECK(table.speakStream(session, stopped, other) == TTS_OK);
+    table.dispatch(SessionTable::SpeechStart, 100 + first);
+    table.dispatch(SessionTable::SpeechCancel, 100 + first);
+    CHECK(waitFor(recorder.mutex, [&] { return recorder.events.back() == "cancel 2"; }));
+    size_t reads = cancelled.reads;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(cancelled.reads == reads && cancelled.next < cancelled.count);
+
+    // An empty source has nothing to speak
+    IteratorTextSource empty([](std::string &) { return false; });
+    SpeechData nothing(3);
+    CHECK(table.speakStream(session, nothing, empty) == TTS_FAIL);
+}
+
+static void testDuplicates() {
+    FakeBackend backend;
+    SessionTable table(backend.submitter(), backend.canceller());
+    Recorder recorder;
+    SessionTable::SessionPtr session = table.create(1, "duplicates", &recorder);
+    session->duplicates.configure(DUPLICATE_MERGE, 100);
+
+    // The repeat follows its original
+    uint32_t serviceid = 0;
+    SpeechData a = speech(1, "Item one");
+    SpeechData repeat = speech(2, "Item one");
+    CHECK(table.speak(session, a, &serviceid) == TTS_OK && serviceid == 100);
+    CHECK(table.speak(session, repeat, &serviceid) == TTS_OK && serviceid == 100);
+    CHECK(backend.submitted.size() == 1);
+
+    SpeechState state = SPEECH_NOT_FOUND;
+    table.dispatch(SessionTable::SpeechStart, 100);
+    CHECK(session->states.get(2, state) && state == SPEECH_IN_PROGRESS);
+    table.dispatch(SessionTable::SpeechComplete, 100);
+    CHECK((recorder.events == std::vector<std::string>{"start 1", "start 2", "complete 1", "complete 2"}));
+
+    // An ended speech isn't merged into, nor is one spoken before the window
+    SpeechData again = speech(3, "Item one");
+    CHECK(table.speak(session, again, &serviceid) == TTS_OK && serviceid == 101);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    SpeechData late = speech(4, "Item one");
+    CHECK(table.speak(session, late, &serviceid) == TTS_OK && serviceid == 102);
+
+    session->duplicates.configure(DUPLICATE_DROP, 0);
+    SpeechData dropped = speech(5, "Item one");
+    CHECK(table.speak(session, dropped, &serviceid) == TTS_SPEECH_DUPLICATE);
+
+    DuplicateStats stats = session->duplicates.stats();
+    CHECK(stats.merged == 1 && stats.dropped == 1 && stats.outsideWindow == 1);
+
+    // Nothing is merged into the speeches the service dropped
+    session->duplicates.configure(DUPLICATE_MERGE, 0);
+    SpeechData b = speech(6, "Item two");
+    CHECK(table.speak(session, b, &serviceid) == TTS_OK && serviceid == 103);
+    table.reset();
+    SpeechData after = speech(7, "Item two");
+    CHECK(table.speak(session, after, &serviceid) == TTS_OK && serviceid == 104);
+    CHECK(session->duplicates.stats().merged == 1);
+}
+
+// The client side of the sessions, backed by the table as the backends are. Only the
+// calls of the speech channels do anything
+struct FakeClient : public TTSClientPrivateInterface {
+    FakeClient(SessionTable &table, const SessionTable::SessionPtr &session) : table(table), session(session) {}
+
+    TTS_Error enableTTS(bool) override { return TTS_OK; }
+    TTS_Error listVoices(std::string &, std::vector<std::string> &) override { return TTS_OK; }
+    TTS_Error setTTSConfiguration(Configuration &) override { return TTS_OK; }
+    TTS_Error getTTSConfiguration(Configuration &, bool) override { return TTS_OK; }
+    bool isTTSEnabled(bool) override { return true; }
+    bool isSessionActiveForApp(uint32_t) override { return true; }
+    TTS_Error acquireResource(uint32_t) override { return TTS_OK; }
+    TTS_Error claimResource(uint32_t) override { return TTS_OK; }
+    TTS_Error releaseResource(uint32_t) override { return TTS_OK; }
+    TTS_Error setResourcePriority(uint32_t, uint32_t) override { return TTS_OK; }
+    uint32_t createSession(uint32_t, std::string, TTSSessionCallback *) override { return session->id; }
+    TTS_Error destroySession(uint32_t) override { return TTS_OK; }
+    bool isActiveSession(uint32_t, bool) override { return true; }
+    TTS_Error setPreemptiveSpeak(uint32_t, bool) override { return TTS_OK; }
+    TTS_Error setSpeechChunking(uint32_t, bool) override { return TTS_OK; }
+    TTS_Error setDuplicateSuppression(uint32_t, DuplicateSpeechPolicy, uint32_t) override { return TTS_OK; }
+    TTS_Error getDuplicateStats(uint32_t, DuplicateStats &) override { return TTS_OK; }
+    TTS_Error setSpeakAhead(uint32_t, uint32_t) override { return TTS_OK; }
+    TTS_Error getSpeechEstimates(uint32_t, std::vector<SpeechEstimate> &) override { return TTS_OK; }
+    TTS_Error requestExtendedEvents(uint32_t, uint32_t) override { return TTS_OK; }
+    TTS_Error speak(uint32_t, SpeechData &data, uint32_t *serviceSpeechId) override { return table.speak(session, data, serviceSpeechId); }
+    TTS_Error speakBatch(uint32_t, std::vector<SpeechData> &, std::vector<TTS_Error> &) override { return TTS_FAIL; }
+    TTS_Error speakStream(uint32_t, SpeechData &, TextSource &) override { return TTS_FAIL; }
+    TTS_Error pause(uint32_t, uint32_t) override { return TTS_OK; }
+    TTS_Error resume(uint32_t, uint32_t) override { return TTS_OK; }
+    TTS_Error abort(uint32_t, bool) override { return TTS_OK; }
+    TTS_Error withdraw(uint32_t, uint32_t serviceSpeechId) override { return table.withdraw(session, serviceSpeechId) ? TTS_OK : TTS_FAIL; }
+    bool isSpeaking(uint32_t, bool) override { return false; }
+    TTS_Error getSpeechState(uint32_t, uint32_t, SpeechState &, bool) override { return TTS_OK; }
+
+    SessionTable &table;
+    SessionTable::SessionPtr session;
+};
+
+// Results of the channel requests by client speech id, completed on the library's threads
+struct Completions {
+    SpeakCompletion completion() {
+        return [this](TTS_Error error, uint32_t speechId, uint32_t) {
+            std::lock_guard<std::mutex> lock(mutex);
+            results.push_back(std::to_string(speechId) + ":" + std::to_string(error));
+        };
+    }
+
+    std::vector<std::string> results;
+    std::mutex mutex;
+};
+
+static void testChannels() {
+    FakeBackend backend;
+    SessionTable table(backend.submitter(), backend.canceller());
+    Recorder recorder;
+    SessionTable::SessionPtr session = table.create(1, "channels", &recorder);
+    FakeClient client(table, session);
+    Completions completions;
+    AsyncSpeechQueue queue(&client);
+    const std::string replaced = std::to_string(TTS_SPEECH_REPLACED);
+    const std::string ok = std::to_string(TTS_OK);
+
+    // Only the last of a burst is spoken, once the channel is quiet
+    queue.setQuietPeriod(session->id, "focus", std::chrono::milliseconds(50));
+    for(uint32_t id = 1; id <= 3; id++)
+        queue.post(session->id, "focus", speech(id, "item " + std::to_string(id)), completions.completion());
+    CHECK(waitFor(completions.mutex, [&] { return completions.results.size() == 3; }));
+    CHECK((completions.results == std::vector<std::string>{"1:" + replaced, "2:" + replaced, "3:" + ok}));
+    CHECK((backend.submitted == std::vector<std::string>{"item 3"}));
+
+    // A newer request withdraws the channel's speech pending at the service
+    queue.setQuietPeriod(session->id, "focus", std::chrono::milliseconds(0));
+    queue.post(session->id, "focus", speech(4, "item 4"), completions.completion());
+    CHECK(waitFor(backend.mutex, [&] { return backend.submitted.size() == 2; }));
+    CHECK(waitFor(backend.mutex, [&] { return backend.cancelled == std::vector<uint32_t>{100}; }));
+    CHECK(waitFor(recorder.mutex, [&] { return recorder.events == std::vector<std::string>{"cancel 3"}; }));
+
+    // But not the one in progress, nor the speeches of the other channels
+    table.dispatch(SessionTable::SpeechStart, 101);
+    queue.post(session->id, speech(5, "plain"), completions.completion());
+    queue.post(session->id, "focus", speech(6, "item 6"), completions.completion());
+    CHECK(waitFor(backend.mutex, [&] { return backend.submitted.size() == 4; }));
+    CHECK(waitFor(completions.mutex, [&] { return completions.results.size() == 6; }));
+    {
+        std::lock_guard<std::mutex> lock(backend.mutex);
+        CHECK((backend.submitted == std::vector<std::string>{"item 3", "item 4", "plain", "item 6"}));
+        CHECK((backend.cancelled == std::vector<uint32_t>{100}));
+    }
+}
+
+// The estimates follow each other, in "ids" order, starting with the one in progress
+static bool isPipelined(const std::vector<SpeechEstimate> &estimates, const std::vector<uint32_t> &ids) {
+    if(estimates.size() != ids.size())
+        return false;
+    uint32_t startsIn = 0;
+    for(size_t i = 0; i < estimates.size(); i++) {
+        if(estimates[i].speechId != ids[i] || estimates[i].startsInMs != startsIn || !estimates[i].durationMs)
+            return false;
+        startsIn += estimates[i].durationMs;
+    }
+    return true;
+}
+
+static void testSpeakAhead() {
+    FakeBackend backend;
+    SessionTable table(backend.submitter(), backend.canceller());
+    Recorder recorder;
+    SessionTable::SessionPtr session = table.create(1, "ahead", &recorder);
+    table.setSpeakAhead(session, 1);
+
+    // The speech in progress and one more are at the service, the others wait
+    uint32_t serviceid = 0;
+    for(uint32_t id = 1; id <= 4; id++) {
+        SpeechData data = speech(id, "speech " + std::to_string(id));
+        CHECK(table.speak(session, data, &serviceid) == TTS_OK && serviceid == (id <= 2 ? 99 + id : 0));
+    }
+    CHECK(backend.submitted.size() == 2);
+    CHECK(isPipelined(table.estimates(session), {1, 2, 3, 4}));
+
+    // The waiting ones are not batched past the depth either
+    std::vector<SpeechData> batch(1, speech(5, "batched"));
+    CHECK(!table.canBatch(session, batch));
+
+    // One moves on as a speech ends
+    table.dispatch(SessionTable::SpeechStart, 100);
+    CHECK(backend.submitted.size() == 2);
+    table.dispatch(SessionTable::SpeechComplete, 100);
+    CHECK((backend.submitted == std::vector<std::string>{"speech 1", "speech 2", "speech 3"}));
+    CHECK(isPipelined(table.estimates(session), {2, 3, 4}));
+
+    // Turning it off submits the others
+    table.setSpeakAhead(session, 0);
+    CHECK(backend.submitted.size() == 4 && backend.submitted.back() == "speech 4");
+    CHECK(table.canBatch(session, batch));
+}
+
+// The speeches which haven't started by their deadline are dropped or cancelled at the
+// service, the deadlines are watched on the library's threads
+static void testDeadlines() {
+    FakeBackend backend;
+    SessionTable table(backend.submitter(), backend.canceller());
+    Recorder recorder;
+    SessionTable::SessionPtr session = table.create(1, "deadlines", &recorder);
+
+    uint32_t serviceid = 0;
+    SpeechData late = speech(9, "late");
+    late.expireIn(std::chrono::milliseconds(0));
+    CHECK(table.speak(session, late, &serviceid) == TTS_SPEECH_EXPIRED);
+    CHECK(backend.submitted.empty());
+
+    // "a" starts in time, "low" is held back & "b" is at the service when they expire
+    SpeechData a = speech(1, "a");
+    SpeechData low = speech(2, "low", SPEECH_PRIORITY_LOW);
+    SpeechData b = speech(3, "b");
+    a.expireIn(std::chrono::milliseconds(30));
+    low.expireIn(std::chrono::milliseconds(60));
+    b.expireIn(std::chrono::milliseconds(30));
+    CHECK(table.speak(session, a, &serviceid) == TTS_OK && serviceid == 100);
+    CHECK(table.speak(session, low, &serviceid) == TTS_OK && serviceid == 0);
+    CHECK(table.speak(session, b, &serviceid) == TTS_OK && serviceid == 101);
+    table.dispatch(SessionTable::SpeechStart, 100);
+
+    CHECK(waitFor(recorder.mutex, [&] { return recorder.events.size() == 3; }));
+    {
+        std::lock_guard<std::mutex> lock(backend.mutex);
+        CHECK((backend.cancelled == std::vector<uint32_t>{101}));
+    }
+    table.dispatch(SessionTable::SpeechComplete, 100);
+    CHECK((recorder.events == std::vector<std::string>{"start 1", "expired 3", "expired 2", "complete 1"}));
+    CHECK(backend.submitted.size() == 2);
+
+    // The speeches with a deadline go through the scheduler
+    std::vector<SpeechData> batch(1, speech(4, "batched"));
+    CHECK(table.canBatch(session, batch));
+    batch.back().expireIn(std::chrono::milliseconds(1000));
+    CHECK(!table.canBatch(session, batch));
+}
+
+int main() {
+    testPriorities();
+    testPreemptive();
+    testChunks();
+    testStream();
+    testDuplicates();
+    testChannels();
+    testSpeakAhead();
+    testDeadlines();
+
+    if(failures)
+        printf("%d check(s) failed\n", failures);
+    else
+        printf("All checks passed\n");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,196 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "AsyncSpeechQueue.h"
+#include "logger.h"
+
+#include <algorithm>
+
+namespace TTS {
+
+// Quiet period of the channels which didn't set one
+#define DEFAULT_QUIET_PERIOD_MS 150
+
+AsyncSpeechQueue::AsyncSpeechQueue(TTSClientPrivateInterface *priv) :
+    m_priv(priv),
+    m_drainPosted(false),
+    m_wakeup(Clock::time_point::max()),
+    m_strand(Executor::Blocking()) {
+}
+
+AsyncSpeechQueue::~AsyncSpeechQueue() {
+    RequestList dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        dropped.swap(m_requests);
+    }
+
+    // Waits for the request being submitted, if any
+    m_strand.stop(true);
+
+    for(auto &request : dropped) {
+        if(request.completion)
+            request.completion(TTS_OBJECT_DESTROYED, request.data.id, 0);
+    }
+}
+
+void AsyncSpeechQueue::post(uint32_t sessionId, SpeechData &&data, SpeakCompletion completion) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_requests.push_back({sessionId, std::move(data), std::move(completion), std::string(), Clock::now()});
+    start();
+}
+
+void AsyncSpeechQueue::post(uint32_t sessionId, const std::string &channel, SpeechData &&data, SpeakCompletion completion) {
+    Request replaced;
+    bool hasReplaced = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::chrono::milliseconds quiet(DEFAULT_QUIET_PERIOD_MS);
+        auto periods = m_quietPeriods.find(sessionId);
+        if(periods != m_quietPeriods.end()) {
+            auto period = periods->second.find(channel);
+            if(period != periods->second.end())
+                quiet = period->second;
+        }
+
+        // The channel's request keeps its place, the quiet period starts over
+        Request request = {sessionId, std::move(data), std::move(completion), channel, Clock::now() + quiet};
+        auto it = std::find_if(m_requests.begin(), m_requests.end(), [sessionId, &channel](const Request &queued) {
+            return queued.sessionId == sessionId && queued.channel == channel;
+        });
+        if(it != m_requests.end()) {
+            replaced = std::move(*it);
+            hasReplaced = true;
+            *it = std::move(request);
+        } else {
+            m_requests.push_back(std::move(request));
+        }
+        withdraw(sessionId, channel);
+        start();
+    }
+
+    if(hasReplaced) {
+        TTSLOG_INFO("Speech with clientid-%d replaced on channel %s", replaced.data.id, channel.c_str());
+        if(replaced.completion)
+            replaced.completion(TTS_SPEECH_REPLACED, replaced.data.id, 0);
+    }
+}
+
+void AsyncSpeechQueue::setQuietPeriod(uint32_t sessionId, const std::string &channel, std::chrono::milliseconds quiet) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quietPeriods[sessionId][channel] = quiet;
+}
+
+void AsyncSpeechQueue::start() {
+    if(m_drainPosted)
+        return;
+
+    m_drainPosted = true;
+    m_strand.post([this] { drain(); });
+}
+
+void AsyncSpeechQueue::withdraw(uint32_t sessionId, const std::string &channel) {
+    auto submitted = m_submitted.find(sessionId);
+    if(submitted == m_submitted.end())
+        return;
+
+    auto speech = submitted->second.find(channel);
+    if(speech == submitted->second.end())
+        return;
+
+    uint32_t serviceSpeechId = speech->second;
+    submitted->second.erase(speech);
+    m_strand.post([this, sessionId, serviceSpeechId] {
+        if(m_priv->withdraw(sessionId, serviceSpeechId) == TTS_OK)
+            TTSLOG_INFO("Speech with serviceid-%u withdrawn, replaced on its channel", serviceSpeechId);
+    });
+}
+
+void AsyncSpeechQueue::clear(uint32_t sessionId) {
+    RequestList dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_submitted.erase(sessionId);
+        for(auto it = m_requests.begin(); it != m_requests.end();) {
+            auto next = std::next(it);
+            if(it->sessionId == sessionId)
+                dropped.splice(dropped.end(), m_requests, it);
+            it = next;
+        }
+    }
+
+    for(auto &request : dropped) {
+        TTSLOG_INFO("Dropping queued speech with clientid-%d", request.data.id);
+        if(request.completion)
+            request.completion(TTS_FAIL, request.data.id, 0);
+    }
+}
+
+void AsyncSpeechQueue::forget(uint32_t sessionId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quietPeriods.erase(sessionId);
+    m_submitted.erase(sessionId);
+}
+
+void AsyncSpeechQueue::drain() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_drainPosted = false;
+    if(Clock::now() >= m_wakeup)
+        m_wakeup = Clock::time_point::max();
+
+    while(m_requests.size() > 0) {
+        // The first request due, channel requests wait for their channel to be quiet
+        auto now = Clock::now();
+        auto next = m_requests.begin();
+        auto wakeup = next->due;
+        for(; next != m_requests.end() && next->due > now; ++next)
+            wakeup = std::min(wakeup, next->due);
+        if(next == m_requests.end()) {
+            // Only one wakeup is kept pending, unless an earlier one is needed
+            if(wakeup < m_wakeup) {
+                m_wakeup = wakeup;
+                m_strand.postAfter(wakeup - now, [this] { drain(); });
+            }
+            break;
+        }
+
+        Request request = std::move(*next);
+        m_requests.erase(next);
+        lock.unlock();
+
+        uint32_t serviceSpeechId = 0;
+        TTS_Error error = m_priv->speak(request.sessionId, request.data, &serviceSpeechId);
+        if(request.completion)
+            request.completion(error, request.data.id, serviceSpeechId);
+
+        lock.lock();
+        if(!request.channel.empty() && error == TTS_OK && serviceSpeechId) {
+            m_submitted[request.sessionId][request.channel] = serviceSpeechId;
+
+            // Replaced while it was being submitted
+            bool replaced = std::any_of(m_requests.begin(), m_requests.end(), [&request](const Request &queued) {
+                return queued.sessionId == request.sessionId && queued.channel == request.channel;
+            });
+            if(replaced)
+                withdraw(request.sessionId, request.channel);
+        }
+    }
+}
+
+} // namespace TTS
@@ -0,0 +1,94 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef _TTS_ASYNC_SPEECH_QUEUE_H_
+#define _TTS_ASYNC_SPEECH_QUEUE_H_
+
+#include "TTSClient.h"
+#include "TTSClientPrivateInterface.h"
+#include "Executor.h"
+
+#include <unordered_map>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <list>
+
+namespace TTS {
+
+// Offloads the blocking speak round trip from the caller's thread.
+// Requests are submitted to the backend in the order they were posted,
+// and the completion is invoked on the executor's blocking lane once the
+// service has accepted (or rejected) the request.
+//
+// A request posted on a channel replaces the channel's request not yet
+// submitted and is held until the channel has been quiet for its quiet
+// period, so that only the last of a burst reaches the service. The
+// channel's last submitted speech is withdrawn as well, unless it started.
+class AsyncSpeechQueue {
+public:
+    AsyncSpeechQueue(TTSClientPrivateInterface *priv);
+    ~AsyncSpeechQueue();
+
+    void post(uint32_t sessionId, SpeechData &&data, SpeakCompletion completion);
+    void post(uint32_t sessionId, const std::string &channel, SpeechData &&data, SpeakCompletion completion);
+    void setQuietPeriod(uint32_t sessionId, const std::string &channel, std::chrono::milliseconds quiet);
+
+    // Drops the requests which are not yet submitted to the service,
+    // those are completed with TTS_FAIL
+    void clear(uint32_t sessionId);
+    // Drops the session's channel settings, once the session is gone
+    void forget(uint32_t sessionId);
+
+private:
+    using Clock = Executor::Clock;
+
+    struct Request {
+        uint32_t sessionId;
+        SpeechData data;
+        SpeakCompletion completion;
+        std::string channel;
+        Clock::time_point due;
+    };
+    using RequestList = std::list<Request>;
+    using QuietPeriods = std::unordered_map<std::string, std::chrono::milliseconds>;
+    // Service id of the channels' last submitted speech
+    using Submitted = std::unordered_map<std::string, uint32_t>;
+
+    AsyncSpeechQueue(AsyncSpeechQueue&) = delete;
+
+    // Submits the requests which are due, runs on m_strand
+    void drain();
+    // Expects m_mutex to be held
+    void start();
+    // Expects m_mutex to be held, the speech is withdrawn on m_strand
+    void withdraw(uint32_t sessionId, const std::string &channel);
+
+    TTSClientPrivateInterface *m_priv;
+    bool m_drainPosted;
+    Clock::time_point m_wakeup;
+    RequestList m_requests;
+    std::unordered_map<uint32_t, QuietPeriods> m_quietPeriods;
+    std::unordered_map<uint32_t, Submitted> m_submitted;
+    std::mutex m_mutex;
+    Executor::Strand m_strand;
+};
+
+} // namespace TTS
+
+#endif //_TTS_ASYNC_SPEECH_QUEUE_H_
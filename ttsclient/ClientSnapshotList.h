@@ -0,0 +1,227 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef _TTS_CLIENT_SNAPSHOT_LIST_H_
+#define _TTS_CLIENT_SNAPSHOT_LIST_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace TTS {
+
+// Copy-on-write list of the clients registered with a service. Writers publish a
+// new immutable snapshot, event dispatch walks the snapshot it loaded without any
+// lock nor allocation, so that client callbacks never run under a service mutex.
+//
+// A dispatch takes one of a fixed set of reader slots, announcing the version of the
+// list it loaded. The snapshots replaced by a writer are freed once no slot announces
+// an older version.
+//
+// remove() returns only once no other thread can still be calling into the removed
+// client (it waits for the dispatches walking an older snapshot to finish). When it
+// is called from within a callback it doesn't wait, as the other dispatches could be
+// waiting on the caller's, the dispatch of the calling thread skips the removed client.
+template<typename ClientType>
+class ClientSnapshotList {
+public:
+    using List = std::vector<ClientType*>;
+
+    // Holds a snapshot for the duration of a dispatch
+    class Reader {
+    public:
+        Reader(ClientSnapshotList &list) : m_list(list) {
+            m_slot = list.enter(m_clients, m_version);
+        }
+        ~Reader() { m_list.leave(m_slot); }
+
+        template<typename Callback>
+        void forEach(Callback callback) {
+            for(ClientType *client : *m_clients) {
+                // Skip the clients removed by an earlier callback of this dispatch
+                if(m_list.m_version.load() != m_version && !m_list.contains(client))
+                    continue;
+                callback(client);
+            }
+        }
+
+        bool empty() const { return m_clients->empty(); }
+
+    private:
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        ClientSnapshotList &m_list;
+        const List *m_clients;
+        uint64_t m_version;
+        typename ClientSnapshotList::Slot *m_slot;
+    };
+
+    ClientSnapshotList() : m_current(new List()), m_version(0) {}
+    ~ClientSnapshotList() {
+        delete m_current.load();
+        for(auto &retired : m_retired)
+            delete retired.second;
+    }
+
+    void add(ClientType *client) {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        const List *current = m_current.load();
+        if(std::find(current->begin(), current->end(), client) != current->end())
+            return;
+
+        List *clients = new List(*current);
+        clients->push_back(client);
+        publish(clients);
+    }
+
+    void remove(ClientType *client) {
+        uint64_t version;
+        {
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            const List *previous = m_current.load();
+            auto it = std::find(previous->begin(), previous->end(), client);
+            if(it == previous->end())
+                return;
+
+            List *clients = new List(*previous);
+            clients->erase(clients->begin() + (it - previous->begin()));
+            version = publish(clients);
+        }
+
+        // Grace period, every dispatch which loaded an older snapshot may still call the client
+        if(inDispatch())
+            return;
+        for(int spins = 0; oldestReader() < version; spins++) {
+            if(spins < GRACE_SPINS)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        publish(new List());
+    }
+
+private:
+    enum { MAX_READERS = 32, GRACE_SPINS = 64 };
+
+    // "entered" is 0 when free, the version of the snapshot walked + 1 otherwise
+    struct Slot {
+        Slot() : entered(0), thread(std::thread::id()) {}
+
+        std::atomic<uint64_t> entered;
+        std::atomic<std::thread::id> thread;
+    };
+
+    ClientSnapshotList(const ClientSnapshotList&) = delete;
+    ClientSnapshotList& operator=(const ClientSnapshotList&) = delete;
+
+    // Loads the snapshot with a slot announcing its version or an older one, a
+    // dispatch only waits for a slot when MAX_READERS are in progress
+    Slot *enter(const List *&clients, uint64_t &version) {
+        for(;;) {
+            for(Slot &slot : m_slots) {
+                uint64_t free = 0;
+                uint64_t announced = m_version.load();
+                if(slot.entered.load(std::memory_order_relaxed) || !slot.entered.compare_exchange_strong(free, announced + 1))
+                    continue;
+
+                slot.thread.store(std::this_thread::get_id());
+                for(;;) {
+                    clients = m_current.load();
+                    uint64_t now = m_version.load();
+                    if(now == announced)
+                        break;
+                    announced = now;
+                    slot.entered.store(announced + 1);
+                }
+                version = announced;
+                return &slot;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void leave(Slot *slot) {
+        slot->thread.store(std::thread::id());
+        slot->entered.store(0);
+    }
+
+    // Only valid within a dispatch, whose slot keeps the current snapshot alive
+    bool contains(ClientType *client) const {
+        const List *clients = m_current.load();
+        return std::find(clients->begin(), clients->end(), client) != clients->end();
+    }
+
+    bool inDispatch() const {
+        std::thread::id self = std::this_thread::get_id();
+        for(const Slot &slot : m_slots) {
+            if(slot.entered.load() && slot.thread.load() == self)
+                return true;
+        }
+        return false;
+    }
+
+    // Version of the oldest snapshot walked, the current one when there is no dispatch
+    uint64_t oldestReader() const {
+        uint64_t oldest = m_version.load();
+        for(const Slot &slot : m_slots) {
+            uint64_t entered = slot.entered.load();
+            if(entered && entered - 1 < oldest)
+                oldest = entered - 1;
+        }
+        return oldest;
+    }
+
+    // Expects m_writeMutex to be held, the snapshot is published before its version
+    // so that a dispatch never announces a newer version than the snapshot it walks
+    uint64_t publish(const List *clients) {
+        const List *previous = m_current.exchange(clients);
+        uint64_t version = m_version.fetch_add(1) + 1;
+        m_retired.emplace_back(version, previous);
+
+        uint64_t oldest = oldestReader();
+        auto kept = std::remove_if(m_retired.begin(), m_retired.end(), [oldest](const std::pair<uint64_t, const List*> &retired) {
+            if(retired.first > oldest)
+                return false;
+            delete retired.second;
+            return true;
+        });
+        m_retired.erase(kept, m_retired.end());
+        return version;
+    }
+
+    std::atomic<const List*> m_current;
+    std::atomic<uint64_t> m_version;
+    Slot m_slots[MAX_READERS];
+    std::mutex m_writeMutex;
+    // Snapshots replaced at a version, freed once every dispatch walks that version or a newer one
+    std::vector<std::pair<uint64_t, const List*>> m_retired;
+};
+
+} // namespace TTS
+
+#endif //_TTS_CLIENT_SNAPSHOT_LIST_H_
@@ -0,0 +1,94 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef _TTS_CONFIGURATION_CACHE_H_
+#define _TTS_CONFIGURATION_CACHE_H_
+
+#include "TTSClient.h"
+
+#include <mutex>
+
+namespace TTS {
+
+// Client side copy of the service's TTS configuration, so that the frequent reads
+// don't need an IPC. It is filled on connect, patched locally after a successful
+// set and invalidated whenever the service may have changed it behind our back.
+class ConfigurationCache {
+public:
+    ConfigurationCache() : m_valid(false), m_generation(0) {}
+
+    bool get(Configuration &config) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_valid)
+            config = m_config;
+        return m_valid;
+    }
+
+    // To be read before fetching the configuration that is then passed to set()
+    uint32_t generation() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_generation;
+    }
+
+    void set(const Configuration &config, uint32_t generation) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Don't let a fetch that raced with invalidate() repopulate the cache
+        if(generation != m_generation)
+            return;
+
+        m_config = config;
+        m_valid = true;
+    }
+
+    // Mirrors the service's handling of setTTSConfiguration(), where the empty /
+    // default fields of the request are left unchanged
+    void update(const Configuration &config) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(!m_valid)
+            return;
+
+        if(!config.ttsEndPoint.empty())
+            m_config.ttsEndPoint = config.ttsEndPoint;
+        if(!config.ttsEndPointSecured.empty())
+            m_config.ttsEndPointSecured = config.ttsEndPointSecured;
+        if(!config.language.empty())
+            m_config.language = config.language;
+        if(!config.voice.empty())
+            m_config.voice = config.voice;
+        if(config.volume)
+            m_config.volume = config.volume;
+        if(config.rate)
+            m_config.rate = config.rate;
+    }
+
+    void invalidate() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_valid = false;
+        ++m_generation;
+    }
+
+private:
+    Configuration m_config;
+    bool m_valid;
+    uint32_t m_generation;
+    std::mutex m_mutex;
+};
+
+} // namespace TTS
+
+#endif //_TTS_CONFIGURATION_CACHE_H_
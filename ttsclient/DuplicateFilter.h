@@ -0,0 +1,183 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef _TTS_DUPLICATE_FILTER_H_
+#define _TTS_DUPLICATE_FILTER_H_
+
+#include "TTSClient.h"
+#include "SpeechStateTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+
+namespace TTS {
+
+// Texts a session requested lately, so that a repeat of a speech still pending or in
+// progress can be dropped or merged into it. The texts are compared by hash & length.
+// Merged repeats follow the events of their original speech. The last "capacity"
+// texts are remembered.
+class DuplicateFilter {
+public:
+    DuplicateFilter(size_t capacity = 64) :
+        m_capacity(capacity ? capacity : 1),
+        m_policy(DUPLICATE_SPEAK),
+        m_window(0),
+        m_stats() {
+    }
+
+    void configure(DuplicateSpeechPolicy policy, uint32_t windowMs) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_policy = policy;
+        m_window = std::chrono::milliseconds(windowMs);
+        if(policy == DUPLICATE_SPEAK)
+            m_recent.clear();
+    }
+
+    DuplicateSpeechPolicy policy() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_policy;
+    }
+
+    // Returns the id of the speech "text" repeats, 0 when it is not a repeat
+    uint32_t match(const std::string &text, SpeechStateTable &states) {
+        size_t hash = std::hash<std::string>()(text);
+        auto now = Clock::now();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.checked;
+        for(auto it = m_recent.rbegin(); it != m_recent.rend(); ++it) {
+            if(it->hash != hash || it->length != text.size() || !isLive(it->id, states))
+                continue;
+
+            if(m_window.count() && now - it->requested > m_window) {
+                ++m_stats.outsideWindow;
+                return 0;
+            }
+            return it->id;
+        }
+        return 0;
+    }
+
+    void record(const std::string &text, uint32_t id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        forget(id);
+        m_recent.push_back({std::hash<std::string>()(text), text.size(), id, Clock::now()});
+        if(m_recent.size() > m_capacity)
+            m_recent.pop_front();
+    }
+
+    void dropped() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.dropped;
+    }
+
+    // Returns false when the original ended meanwhile
+    bool merge(uint32_t original, uint32_t repeat, SpeechStateTable &states) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        SpeechState state;
+        states.get(original, state);
+        if(state == SPEECH_NOT_FOUND)
+            return false;
+
+        forget(repeat);
+        states.set(repeat, state);
+        m_followers[original].push_back(repeat);
+        ++m_stats.merged;
+        return true;
+    }
+
+    // Repeats merged into the speech, handed out for the last time once it ended
+    std::vector<uint32_t> followers(uint32_t id, bool ended) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_followers.find(id);
+        if(it == m_followers.end())
+            return {};
+
+        if(!ended)
+            return it->second;
+        std::vector<uint32_t> followers = std::move(it->second);
+        m_followers.erase(it);
+        return followers;
+    }
+
+    // The speeches are gone (the service dropped them, or the session is destroyed)
+    // and so are their repeats
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_recent.clear();
+        m_followers.clear();
+    }
+
+    DuplicateStats stats() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Recent {
+        size_t hash;
+        size_t length;
+        uint32_t id;
+        Clock::time_point requested;
+    };
+
+    bool isLive(uint32_t id, SpeechStateTable &states) {
+        SpeechState state;
+        states.get(id, state);
+        return state != SPEECH_NOT_FOUND;
+    }
+
+    // The id is reused by another speech, neither its repeats nor the speech it
+    // repeated follow it any more
+    void forget(uint32_t id) {
+        for(auto it = m_recent.begin(); it != m_recent.end(); ++it) {
+            if(it->id == id) {
+                m_recent.erase(it);
+                break;
+            }
+        }
+
+        m_followers.erase(id);
+        for(auto it = m_followers.begin(); it != m_followers.end();) {
+            auto &followers = it->second;
+            followers.erase(std::remove(followers.begin(), followers.end(), id), followers.end());
+            if(followers.empty())
+                it = m_followers.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    const size_t m_capacity;
+    DuplicateSpeechPolicy m_policy;
+    std::chrono::milliseconds m_window;
+    std::deque<Recent> m_recent;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_followers;
+    DuplicateStats m_stats;
+    std::mutex m_mutex;
+};
+
+} // namespace TTS
+
+#endif //_TTS_DUPLICATE_FILTER_H_
@@ -0,0 +1,79 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef _TTS_DURATION_PREDICTOR_H_
+#define _TTS_DURATION_PREDICTOR_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace TTS {
+
+// Predicts how long a text takes to speak from its length and the speech rate
+// (1-100, 50 being the engine's normal pace). The time per character at rate 50 is
+// learnt from the Start -> Complete times of the speeches spoken without a pause.
+// Not thread safe, expected to be used under its owner's lock.
+class DurationPredictor {
+public:
+    using Duration = std::chrono::milliseconds;
+
+    DurationPredictor() :
+        m_rate(NORMAL_RATE),
+        m_usPerChar(DEFAULT_US_PER_CHAR),
+        m_samples(0) {
+    }
+
+    void setRate(uint8_t rate) {
+        if(rate)
+            m_rate = rate;
+    }
+
+    Duration predict(size_t length) const {
+        uint64_t us = (uint64_t)length * m_usPerChar * NORMAL_RATE / m_rate;
+        return Duration(STARTUP_MS + us / 1000);
+    }
+
+    void observe(size_t length, Duration took) {
+        // Short texts tell more about the engine's start up than its pace
+        if(length < MIN_SAMPLE_LENGTH || took.count() <= STARTUP_MS)
+            return;
+
+        uint64_t usPerChar = (uint64_t)(took.count() - STARTUP_MS) * 1000 * m_rate / NORMAL_RATE / length;
+        // Moving average, the first samples weigh more so that it settles quickly
+        uint64_t weight = SAMPLE_WEIGHT;
+        if(m_samples < SAMPLE_WEIGHT)
+            weight = ++m_samples;
+        m_usPerChar = (m_usPerChar * (weight - 1) + usPerChar) / weight;
+    }
+
+private:
+    static const uint32_t NORMAL_RATE = 50;
+    static const uint64_t DEFAULT_US_PER_CHAR = 70000;   // ~14 characters per second
+    static const int64_t STARTUP_MS = 150;
+    static const size_t MIN_SAMPLE_LENGTH = 16;
+    static const uint64_t SAMPLE_WEIGHT = 8;
+
+    uint32_t m_rate;
+    uint64_t m_usPerChar;
+    uint64_t m_samples;
+};
+
+} // namespace TTS
+
+#endif //_TTS_DURATION_PREDICTOR_H_
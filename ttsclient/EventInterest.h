@@ -0,0 +1,68 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef _TTS_EVENT_INTEREST_H_
+#define _TTS_EVENT_INTEREST_H_
+
+#include "TTSCommon.h"
+
+#include <atomic>
+#include <unordered_map>
+#include <mutex>
+
+namespace TTS {
+
+// Speech events a service subscribes to on demand. The others end the speeches,
+// the clients need them to track their speeches whatever the apps asked for.
+static const uint32_t OPTIONAL_SPEECH_EVENTS = EXT_EVENT_PAUSED | EXT_EVENT_RESUMED;
+
+// Optional speech events each client of a service wants (the union of what its
+// sessions requested), the service subscribes to the union alone
+template<typename ClientType>
+class EventInterest {
+public:
+    EventInterest() : m_wanted(0) {}
+
+    // Returns true when the union changed
+    bool set(ClientType *client, uint32_t events) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        events &= OPTIONAL_SPEECH_EVENTS;
+        if(events)
+            m_interest[client] = events;
+        else
+            m_interest.erase(client);
+
+        uint32_t wanted = 0;
+        for(auto &interest : m_interest)
+            wanted |= interest.second;
+        return m_wanted.exchange(wanted) != wanted;
+    }
+
+    uint32_t wanted() const {
+        return m_wanted.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::unordered_map<ClientType*, uint32_t> m_interest;
+    std::atomic<uint32_t> m_wanted;
+    std::mutex m_mutex;
+};
+
+} // namespace TTS
+
+#endif //_TTS_EVENT_INTEREST_H_
@@ -0,0 +1,100 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef _TTS_EVENT_RING_H_
+#define _TTS_EVENT_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace TTS {
+
+// Fixed capacity multi producer, single consumer ring of trivially copyable
+// records. push() may be called from any thread, pop() and empty() only from
+// the consumer. Neither allocates, a full ring makes push() fail.
+template<typename T, size_t Capacity>
+class EventRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "Records must be trivially copyable");
+
+public:
+    EventRing() : m_head(0), m_tail(0) {
+        for(size_t i = 0; i < Capacity; i++)
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    bool push(const T &record) {
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+        Cell *cell;
+        while(1) {
+            cell = &m_cells[pos & (Capacity - 1)];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+            if(diff == 0) {
+                if(m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if(diff < 0) {
+                return false;
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->record = record;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &record) {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+        Cell &cell = m_cells[pos & (Capacity - 1)];
+        if(cell.sequence.load(std::memory_order_acquire) != pos + 1)
+            return false;
+
+        record = cell.record;
+        cell.sequence.store(pos + Capacity, std::memory_order_release);
+        m_head.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Sequentially consistent, so that it pairs with a producer that publishes
+    // and then checks whether the consumer went to sleep
+    bool empty() const {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+        return m_cells[pos & (Capacity - 1)].sequence.load(std::memory_order_seq_cst) != pos + 1;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T record;
+    };
+
+    // Producers and the consumer work on separate cache lines
+    alignas(64) Cell m_cells[Capacity];
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+};
+
+} // namespace TTS
+
+#endif //_TTS_EVENT_RING_H_
@@ -0,0 +1,265 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "Executor.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <map>
+#include <sys/resource.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+
+#define EXECUTOR_DEFAULT_THREADS 2
+#define EXECUTOR_MAX_THREADS 8
+#define BLOCKING_DEFAULT_THREADS 16
+#define BLOCKING_MAX_THREADS 64
+
+namespace TTS {
+
+static thread_local Executor::Strand *currentStrand = nullptr;
+
+// Single thread keeping the delayed jobs of every strand, started with the first one
+class Timer {
+public:
+    static Timer &Instance() {
+        // Never destroyed, like the executors it posts to
+        static Timer *instance = new Timer();
+        return *instance;
+    }
+
+    bool add(Executor::Clock::duration delay, Executor::Strand *strand, bool &accepting, std::mutex &strandMutex, Executor::Job job) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        {
+            std::lock_guard<std::mutex> strandLock(strandMutex);
+            if(!accepting)
+                return false;
+        }
+
+        auto due = Executor::Clock::now() + delay;
+        bool earliest = m_entries.empty() || due < m_entries.begin()->first;
+        m_entries.emplace(due, Entry{strand, std::move(job)});
+        if(!m_thread)
+            m_thread = new std::thread(&Timer::run, this);
+        else if(earliest)
+            m_condition.notify_one();
+        return true;
+    }
+
+    void cancel(Executor::Strand *strand) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for(auto it = m_entries.begin(); it != m_entries.end();) {
+            if(it->second.strand == strand)
+                it = m_entries.erase(it);
+            else
+                ++it;
+        }
+    }
+
+private:
+    struct Entry {
+        Executor::Strand *strand;
+        Executor::Job job;
+    };
+
+    Timer() : m_thread(nullptr) {}
+
+    void run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while(1) {
+            if(m_entries.empty()) {
+                m_condition.wait(lock);
+                continue;
+            }
+
+            auto first = m_entries.begin();
+            if(first->first > Executor::Clock::now()) {
+                m_condition.wait_until(lock, first->first);
+                continue;
+            }
+
+            // Posted under the lock, so that a strand which cancelled its entries
+            // in stop() is never posted to afterwards
+            Entry entry = std::move(first->second);
+            m_entries.erase(first);
+            entry.strand->post(std::move(entry.job));
+        }
+    }
+
+    std::multimap<Executor::Clock::time_point, Entry> m_entries;
+    std::thread *m_thread;
+    std::condition_variable m_condition;
+    std::mutex m_mutex;
+};
+
+Executor::Strand::Strand(Executor &executor) :
+    m_executor(executor),
+    m_scheduled(false),
+    m_accepting(true) {
+}
+
+Executor::Strand::~Strand() {
+    stop(false);
+}
+
+bool Executor::Strand::post(Job job) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if(!m_accepting)
+        return false;
+
+    m_jobs.push_back(std::move(job));
+    if(m_scheduled)
+        return true;
+
+    m_scheduled = true;
+    lock.unlock();
+
+    m_executor.post([this] { run(); });
+    return true;
+}
+
+bool Executor::Strand::postAfter(Clock::duration delay, Job job) {
+    return Timer::Instance().add(delay, this, m_accepting, m_mutex, std::move(job));
+}
+
+void Executor::Strand::stop(bool discard) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_accepting = false;
+    lock.unlock();
+
+    // Nothing is added to the timer once m_accepting is cleared
+    Timer::Instance().cancel(this);
+
+    lock.lock();
+    if(discard)
+        m_jobs.clear();
+
+    if(currentStrand == this)
+        return;
+
+    m_idle.wait(lock, [this] { return !m_scheduled; });
+}
+
+void Executor::Strand::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    currentStrand = this;
+    while(m_jobs.size() > 0) {
+        Job job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        lock.unlock();
+
+        job();
+
+        lock.lock();
+    }
+    currentStrand = nullptr;
+    m_scheduled = false;
+    m_idle.notify_all();
+}
+
+Executor &Executor::Instance() {
+    // Never destroyed, services may still post jobs from their static destructors
+    static Executor *instance = new Executor("TTS_CLIENT_EXECUTOR_THREADS", EXECUTOR_DEFAULT_THREADS, EXECUTOR_MAX_THREADS, false);
+    return *instance;
+}
+
+Executor &Executor::Blocking() {
+    static Executor *instance = new Executor("TTS_CLIENT_BLOCKING_THREADS", BLOCKING_DEFAULT_THREADS, BLOCKING_MAX_THREADS, true);
+    return *instance;
+}
+
+Executor::Executor(const char *name, size_t size, size_t limit, bool elastic) :
+    m_name(name),
+    m_size(size),
+    m_elastic(elastic),
+    m_busy(0),
+    m_nice(0) {
+    if(const char *threads = getenv(name)) {
+        int size = atoi(threads);
+        if(size > 0)
+            m_size = std::min((size_t)size, limit);
+    }
+
+    if(const char *nice = getenv("TTS_CLIENT_EXECUTOR_NICE"))
+        m_nice = atoi(nice);
+
+    if(const char *cpus = getenv("TTS_CLIENT_EXECUTOR_CPUS")) {
+        std::stringstream list(cpus);
+        std::string cpu;
+        while(std::getline(list, cpu, ','))
+            if(!cpu.empty())
+                m_cpus.push_back(atoi(cpu.c_str()));
+    }
+
+    TTSLOG_INFO("Executor (%s) with %s%zu threads, nice=%d, %zu cpus", m_name, m_elastic ? "up to " : "", m_size, m_nice, m_cpus.size());
+}
+
+void Executor::post(Job job) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.push_back(std::move(job));
+    m_condition.notify_one();
+
+    if(m_threads.empty() || m_elastic)
+        start();
+}
+
+void Executor::start() {
+    // A strand has at most one job posted, an elastic executor keeps a thread for each
+    // busy strand. Its threads are persistent too, they wait for the next burst
+    if(!m_elastic) {
+        for(size_t i = 0; i < m_size; i++)
+            m_threads.push_back(new std::thread(&Executor::run, this));
+    } else if(m_jobs.size() + m_busy > m_threads.size() && m_threads.size() < m_size) {
+        m_threads.push_back(new std::thread(&Executor::run, this));
+        TTSLOG_VERBOSE("Executor (%s) grown to %zu threads", m_name, m_threads.size());
+    }
+}
+
+void Executor::run() {
+    if(m_nice && setpriority(PRIO_PROCESS, syscall(__NR_gettid), m_nice) != 0)
+        TTSLOG_WARNING("Couldn't set the nice value of the executor thread to %d", m_nice);
+
+    if(m_cpus.size() > 0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        for(int cpu : m_cpus)
+            CPU_SET(cpu, &cpuset);
+        if(pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) != 0)
+            TTSLOG_WARNING("Couldn't set the CPU affinity of the executor thread");
+    }
+
+    TTSLOG_VERBOSE("Started Executor thread");
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(1) {
+        m_condition.wait(lock, [this] { return m_jobs.size() > 0; });
+
+        Job job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_busy++;
+        lock.unlock();
+
+        job();
+
+        lock.lock();
+        m_busy--;
+    }
+}
+
+} // namespace TTS
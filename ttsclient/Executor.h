@@ -0,0 +1,110 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef _TTS_EXECUTOR_H_
+#define _TTS_EXECUTOR_H_
+
+#include <condition_variable>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <list>
+
+namespace TTS {
+
+// Small pool of persistent threads shared by the services of the library.
+// It is sized and placed through the environment, read when the first job is posted
+//   TTS_CLIENT_EXECUTOR_THREADS - number of threads (default 2, at most 8)
+//   TTS_CLIENT_BLOCKING_THREADS - most threads of the blocking lane (default 16, at most 64)
+//   TTS_CLIENT_EXECUTOR_NICE    - nice value of the threads, of both pools
+//   TTS_CLIENT_EXECUTOR_CPUS    - comma separated list of the CPUs to run on, of both pools
+//
+// Jobs which block on an RPC or wait for the service go to the Blocking() lane, a
+// second pool, so that they never hold up the event dispatch. It grows to a thread
+// per job running or queued, that is to the number of strands busy at once, so that
+// a strand blocked on a slow service never holds up another one (the deadline checks
+// of a client behind the RPCs of another). Delayed jobs are kept by a single timer
+// thread which posts them to their strand once due.
+class Executor {
+public:
+    using Job = std::function<void ()>;
+    using Clock = std::chrono::steady_clock;
+
+    // Runs its jobs one at a time, in posting order, on the threads of its executor
+    class Strand {
+    public:
+        Strand(Executor &executor = Executor::Instance());
+        ~Strand();
+
+        // Returns false once the strand is stopped
+        bool post(Job job);
+
+        // Posts the job once "delay" passed, it is dropped if the strand is
+        // stopped by then
+        bool postAfter(Clock::duration delay, Job job);
+
+        // Stops accepting jobs and waits for the strand to go idle, the pending
+        // jobs are dropped when "discard" is set. Called from one of the strand's
+        // own jobs, it doesn't wait
+        void stop(bool discard);
+
+    private:
+        Strand(const Strand&) = delete;
+        Strand& operator=(const Strand&) = delete;
+
+        void run();
+
+        Executor &m_executor;
+        std::list<Job> m_jobs;
+        bool m_scheduled;
+        bool m_accepting;
+        std::condition_variable m_idle;
+        std::mutex m_mutex;
+    };
+
+    static Executor &Instance();
+    static Executor &Blocking();
+
+    void post(Job job);
+
+private:
+    // An elastic executor starts a thread per job running or queued, up to "size"
+    Executor(const char *name, size_t size, size_t limit, bool elastic);
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    void start();
+    void run();
+
+    const char *m_name;
+    size_t m_size;
+    const bool m_elastic;
+    size_t m_busy;
+    int m_nice;
+    std::vector<int> m_cpus;
+    std::vector<std::thread*> m_threads;
+    std::list<Job> m_jobs;
+    std::condition_variable m_condition;
+    std::mutex m_mutex;
+};
+
+} // namespace TTS
+
+#endif //_TTS_EXECUTOR_H_
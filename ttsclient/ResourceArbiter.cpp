@@ -0,0 +1,345 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "ResourceArbiter.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <strings.h>
+#include <cstdlib>
+
+namespace TTS {
+
+ResourceArbiter &ResourceArbiter::Instance() {
+    // Never destroyed, clients may still go away from static destructors
+    static ResourceArbiter *instance = new ResourceArbiter();
+    return *instance;
+}
+
+ResourceArbiter::ResourceArbiter() :
+    m_policy(OPEN),
+    m_holder(0),
+    m_holderPriority(0),
+    m_reserved(0),
+    m_claimed(false) {
+    if(const char *policy = getenv("TTS_CLIENT_RESOURCE_POLICY")) {
+        if(strcasecmp(policy, "reservation") == 0)
+            m_policy = RESERVATION;
+        else if(strcasecmp(policy, "priority") == 0)
+            m_policy = PRIORITY;
+        else if(strcasecmp(policy, "open") != 0)
+            TTSLOG_WARNING("Unknown resource policy \"%s\", using open", policy);
+    }
+
+    TTSLOG_INFO("Resource allocation policy %s", m_policy == RESERVATION ? "reservation" : (m_policy == PRIORITY ? "priority" : "open"));
+}
+
+void ResourceArbiter::registerTable(SessionTable *table) {
+    std::lock_guard<std::mutex> lock(m_tablesMutex);
+    m_tables.push_back(table);
+}
+
+void ResourceArbiter::unregisterTable(SessionTable *table) {
+    std::lock_guard<std::mutex> lock(m_tablesMutex);
+    m_tables.erase(std::remove(m_tables.begin(), m_tables.end(), table), m_tables.end());
+}
+
+TTS_Error ResourceArbiter::acquire(uint32_t appId) {
+    if(m_policy == OPEN)
+        return TTS_OK;
+
+    if(!appId)
+        return TTS_EMPTY_APPID_INPUT;
+
+    // The tables are looked up before taking m_mutex, the holder's priority is the one
+    // it had when it got the resource
+    Clock::time_point start = Clock::now();
+    if(!hasSession(appId))
+        return TTS_APP_NOT_FOUND;
+    uint32_t priority = (m_policy == PRIORITY) ? priorityOf(appId) : 0;
+
+    TTS_Error error = TTS_OK;
+    NotificationList notifications;
+    CancellationList cancellations;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_holder == appId)
+            return TTS_OK;
+
+        uint32_t holder = m_holder;
+        bool preempted = false;
+        if(holder && m_policy == PRIORITY) {
+            uint32_t holderPriority = m_holderPriority;
+            if(priority <= holderPriority) {
+                if(wait(appId, priority, start, false)) {
+                    ++m_stats.queued;
+                    TTSLOG_INFO("App %u (priority %u) waits for the resource held by app %u (priority %u)", appId, priority, holder, holderPriority);
+                }
+                error = TTS_RESOURCE_BUSY;
+            } else {
+                // The holder is cut short and waits to get the resource back
+                TTSLOG_INFO("App %u (priority %u) preempts app %u (priority %u)", appId, priority, holder, holderPriority);
+                wait(holder, holderPriority, start, true);
+                ++m_stats.preempted;
+                preempted = true;
+            }
+        } else if(holder) {
+            ++m_stats.rejected;
+            TTSLOG_WARNING("App %u can't acquire the resource, held by app %u", appId, holder);
+            return TTS_RESOURCE_BUSY;
+        }
+
+        if(error == TTS_OK) {
+            stopWaiting(appId);
+            grant(appId, priority, start, notifications);
+            if(preempted)
+                preempt(holder, cancellations);
+        }
+    }
+    cancel(cancellations);
+    notify(notifications);
+
+    // Its last session may have gone since it was looked up
+    if(!hasSession(appId))
+        sessionDestroyed(appId);
+    return error;
+}
+
+TTS_Error ResourceArbiter::claim(uint32_t appId) {
+    if(m_policy == OPEN)
+        return TTS_OK;
+
+    if(m_policy != RESERVATION)
+        return TTS_POLICY_VIOLATION;
+
+    if(!appId)
+        return TTS_EMPTY_APPID_INPUT;
+
+    Clock::time_point start = Clock::now();
+    if(!hasSession(appId))
+        return TTS_APP_NOT_FOUND;
+
+    NotificationList notifications;
+    CancellationList cancellations;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_holder == appId)
+            return TTS_OK;
+
+        if(m_claimed) {
+            ++m_stats.rejected;
+            TTSLOG_WARNING("App %u can't claim the resource, claimed by app %u", appId, m_holder.load());
+            return TTS_NESTED_CLAIM_REQUEST;
+        }
+
+        // The holder's speeches are cut short, it gets the resource back on release
+        uint32_t holder = m_holder;
+        if(holder)
+            ++m_stats.preempted;
+
+        m_claimed = true;
+        m_reserved = holder;
+        grant(appId, 0, start, notifications);
+        if(holder)
+            preempt(holder, cancellations);
+    }
+    cancel(cancellations);
+    notify(notifications);
+
+    // Its last session may have gone since it was looked up
+    if(!hasSession(appId))
+        sessionDestroyed(appId);
+    return TTS_OK;
+}
+
+TTS_Error ResourceArbiter::release(uint32_t appId) {
+    if(m_policy == OPEN)
+        return TTS_OK;
+
+    NotificationList notifications;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_claimed && m_reserved == appId) {
+            // Gives up the reservation it would get back after the claim
+            m_reserved = 0;
+            return TTS_OK;
+        }
+
+        if(stopWaiting(appId))
+            return TTS_OK;
+
+        if(!appId || m_holder != appId) {
+            TTSLOG_WARNING("App %u doesn't hold the resource", appId);
+            return TTS_FAIL;
+        }
+
+        releaseHolder(notifications);
+    }
+    notify(notifications);
+    return TTS_OK;
+}
+
+void ResourceArbiter::sessionDestroyed(uint32_t appId) {
+    if(m_policy == OPEN)
+        return;
+
+    if(hasSession(appId))
+        return;
+
+    NotificationList notifications;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_claimed && m_reserved == appId)
+            m_reserved = 0;
+        stopWaiting(appId);
+
+        if(m_holder != appId)
+            return;
+
+        TTSLOG_INFO("App %u holding the resource is gone", appId);
+        releaseHolder(notifications);
+    }
+    notify(notifications);
+}
+
+ResourceStats ResourceArbiter::stats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+bool ResourceArbiter::hasSession(uint32_t appId) {
+    std::lock_guard<std::mutex> lock(m_tablesMutex);
+    for(auto table : m_tables) {
+        if(table->findForApp(appId))
+            return true;
+    }
+    return false;
+}
+
+uint32_t ResourceArbiter::priorityOf(uint32_t appId) {
+    uint32_t priority = 0;
+    std::lock_guard<std::mutex> lock(m_tablesMutex);
+    for(auto table : m_tables) {
+        SessionTable::SessionPtr session = table->findForApp(appId);
+        if(session)
+            priority = std::max(priority, session->resourcePriority.load());
+    }
+    return priority;
+}
+
+void ResourceArbiter::preempt(uint32_t appId, CancellationList &cancellations) {
+    std::lock_guard<std::mutex> lock(m_tablesMutex);
+    for(auto table : m_tables) {
+        std::vector<uint32_t> speeches = table->submittedSpeeches(appId);
+        if(!speeches.empty())
+            cancellations.push_back({table->canceller(), std::move(speeches)});
+    }
+}
+
+void ResourceArbiter::cancel(const CancellationList &cancellations) {
+    for(auto &cancellation : cancellations) {
+        for(auto serviceid : cancellation.speeches)
+            cancellation.canceller(serviceid);
+    }
+}
+
+bool ResourceArbiter::wait(uint32_t appId, uint32_t priority, Clock::time_point since, bool first) {
+    for(auto &waiter : m_waiting) {
+        if(waiter.appId == appId)
+            return false;
+    }
+
+    // Served by priority, in order of arrival unless it goes ahead of its peers
+    auto pos = std::find_if(m_waiting.begin(), m_waiting.end(), [priority, first](const Waiter &waiter) {
+        return first ? waiter.priority <= priority : waiter.priority < priority;
+    });
+    m_waiting.insert(pos, {appId, priority, since});
+    return true;
+}
+
+bool ResourceArbiter::stopWaiting(uint32_t appId) {
+    auto it = std::find_if(m_waiting.begin(), m_waiting.end(), [appId](const Waiter &waiter) { return waiter.appId == appId; });
+    if(it == m_waiting.end())
+        return false;
+    m_waiting.erase(it);
+    return true;
+}
+
+void ResourceArbiter::releaseHolder(NotificationList &notifications) {
+    // The apps whose last session is gone are no longer reserved nor waiting,
+    // sessionDestroyed() dropped them
+    uint32_t next = 0;
+    uint32_t priority = 0;
+    Clock::time_point since = Clock::now();
+    if(m_policy == RESERVATION) {
+        if(m_claimed)
+            next = m_reserved;
+        m_claimed = false;
+        m_reserved = 0;
+    } else if(!m_waiting.empty()) {
+        Waiter waiter = m_waiting.front();
+        m_waiting.pop_front();
+        next = waiter.appId;
+        priority = waiter.priority;
+        since = waiter.since;
+    }
+    grant(next, priority, since, notifications);
+}
+
+void ResourceArbiter::grant(uint32_t appId, uint32_t priority, Clock::time_point since, NotificationList &notifications) {
+    uint32_t holder = m_holder;
+    TTSLOG_INFO("Resource handed over from app %u to app %u", holder, appId);
+    if(holder)
+        collect(holder, false, notifications);
+
+    m_holder = appId;
+    m_holderPriority = priority;
+    if(!appId)
+        return;
+
+    collect(appId, true, notifications);
+    uint64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since).count();
+    ++m_stats.granted;
+    m_stats.totalLatencyUs += latency;
+    m_stats.maxLatencyUs = std::max(m_stats.maxLatencyUs, latency);
+}
+
+void ResourceArbiter::collect(uint32_t appId, bool acquired, NotificationList &notifications) {
+    std::lock_guard<std::mutex> lock(m_tablesMutex);
+    for(auto table : m_tables) {
+        SessionTable::SessionPtr session = table->findForApp(appId);
+        if(session)
+            notifications.push_back({session, acquired});
+    }
+}
+
+void ResourceArbiter::notify(const NotificationList &notifications) {
+    for(auto &notification : notifications) {
+        TTSSessionCallback *callback = notification.session->callback;
+        if(!callback)
+            continue;
+
+        if(notification.acquired)
+            callback->onResourceAcquired(notification.session->appId, notification.session->id);
+        else
+            callback->onResourceReleased(notification.session->appId, notification.session->id);
+    }
+}
+
+} // namespace TTS
@@ -0,0 +1,125 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef _TTS_RESOURCE_ARBITER_H_
+#define _TTS_RESOURCE_ARBITER_H_
+
+#include "TTSCommon.h"
+#include "TTSClient.h"
+#include "SessionTable.h"
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace TTS {
+
+// Arbitrates the TTS engine between the apps of all the clients in the process,
+// as per the policy read from TTS_CLIENT_RESOURCE_POLICY
+//   "open" (default) - every app speaks freely, the resource APIs are no-ops
+//   "reservation"    - only the app holding the resource speaks. It is taken with
+//                      acquireResource when free, or with claimResource from the holder,
+//                      which gets it back once the claimer releases it
+//   "priority"       - only the app holding the resource speaks. acquireResource from a
+//                      higher priority app preempts the holder, the others wait in a
+//                      queue served by priority as the resource is released
+class ResourceArbiter {
+public:
+    static ResourceArbiter &Instance();
+
+    ResourceAllocationPolicy policy() const { return m_policy; }
+
+    void registerTable(SessionTable *table);
+    void unregisterTable(SessionTable *table);
+
+    TTS_Error acquire(uint32_t appId);
+    TTS_Error claim(uint32_t appId);
+    TTS_Error release(uint32_t appId);
+
+    // Whether the app may speak now, answered without any IPC
+    bool isActive(uint32_t appId) const {
+        return m_policy == OPEN || m_holder == appId;
+    }
+
+    // Called once a session of the app is destroyed, the resource is released
+    // when the app has no session left
+    void sessionDestroyed(uint32_t appId);
+
+    ResourceStats stats();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Notification {
+        SessionTable::SessionPtr session;
+        bool acquired;
+    };
+    using NotificationList = std::vector<Notification>;
+
+    // Speeches of a preempted app, cancelled once m_mutex is released
+    struct Cancellation {
+        SessionTable::Canceller canceller;
+        std::vector<uint32_t> speeches;
+    };
+    using CancellationList = std::vector<Cancellation>;
+
+    struct Waiter {
+        uint32_t appId;
+        uint32_t priority;
+        Clock::time_point since;
+    };
+    using WaiterList = std::list<Waiter>;
+
+    ResourceArbiter();
+    ResourceArbiter(const ResourceArbiter&) = delete;
+    ResourceArbiter& operator=(const ResourceArbiter&) = delete;
+
+    // Look the app up in the tables, never called under m_mutex
+    bool hasSession(uint32_t appId);
+    uint32_t priorityOf(uint32_t appId);
+    // Expects the resource to be handed over already, so that submit() cancels
+    // the app's speeches it records from then on
+    void preempt(uint32_t appId, CancellationList &cancellations);
+    void cancel(const CancellationList &cancellations);
+    bool wait(uint32_t appId, uint32_t priority, Clock::time_point since, bool first);
+    bool stopWaiting(uint32_t appId);
+    void releaseHolder(NotificationList &notifications);
+    void grant(uint32_t appId, uint32_t priority, Clock::time_point since, NotificationList &notifications);
+    void collect(uint32_t appId, bool acquired, NotificationList &notifications);
+    void notify(const NotificationList &notifications);
+
+    ResourceAllocationPolicy m_policy;
+    std::vector<SessionTable*> m_tables;
+    std::mutex m_tablesMutex;
+    std::atomic<uint32_t> m_holder;
+    // Priority the holder had when it got the resource
+    uint32_t m_holderPriority;
+    // Reservation: holder whose reservation was taken over by a claim
+    uint32_t m_reserved;
+    bool m_claimed;
+    // Priority: apps waiting for the resource, highest priority first
+    WaiterList m_waiting;
+    ResourceStats m_stats;
+    std::mutex m_mutex;
+};
+
+} // namespace TTS
+
+#endif //_TTS_RESOURCE_ARBITER_H_
@@ -34,6 +34,7 @@ MODULE_NAME_DECLARATION(BUILD_REFERENCE);
 #define MAX_SECURITY_TOKEN_SIZE 1024
 #define PLUGIN_ACTIVATION_TIMEOUT 2000
 #define STATE_CHANGE_HANDLER_INSTALLATION_FAILURE_THRESHOLD 3
+#define ACTIVATION_POLL_INTERVAL 250 /* milliseconds */
 
 namespace TTSThunderClient {
 
@@ -42,44 +43,16 @@ std::mutex Service::m_serviceListMutex;
 std::once_flag Service::m_installStateChangeHandler;
 
 void Service::AsyncWorker::post(Task task) {
-    m_mutex.lock();
-    m_tasklist.push_back(task);
-    bool running = m_running;
-    m_mutex.unlock();
-
-    if(running)
-        return;
-
-    cleanup();
-    m_thread = new std::thread([](void *data) {
-        AsyncWorker *worker = (AsyncWorker*)data;
-
-        worker->m_mutex.lock();
-        worker->m_running = true;
-
-        while(1) {
-            if(worker->m_tasklist.size() == 0)
-                break;
-
-            Task task = worker->m_tasklist.front();
-            worker->m_tasklist.pop_front();
-            worker->m_mutex.unlock();
-            task(worker->m_service);
-            worker->m_mutex.lock();
-        }
+    // Tasks run in order on the library's blocking lane
+    m_strand.post([this, task] { task(m_service); });
+}
 
-        worker->m_running = false;
-        worker->m_mutex.unlock();
-    }, this);
+void Service::AsyncWorker::postAfter(std::chrono::milliseconds delay, Task task) {
+    m_strand.postAfter(delay, [this, task] { task(m_service); });
 }
 
 void Service::AsyncWorker::cleanup() {
-    if(!m_thread)
-        return;
-
-    m_thread->join();
-    delete m_thread;
-    m_thread = nullptr;
+    m_strand.stop(false);
 }
 
 std::string Service::getSecurityToken(const std::string &payload)
@@ -139,35 +112,38 @@ WPEFrameworkPluginPtr Service::controller(const std::string &payload)
 
 void Service::notifyClientsOfActivation()
 {
-    std::unique_lock<std::mutex> lock(m_mutex);
-    for(ClientList::iterator it = m_clients.begin(); it != m_clients.end(); ++it) {
-        ((Service::Client*)(*it))->onActivation();
-    }
+    ClientList::Reader clients(m_clients);
+    clients.forEach([](Service::Client *client) { client->onActivation(); });
 }
 
 void Service::notifyClientsOfDeactivation()
 {
-    std::unique_lock<std::mutex> lock(m_mutex);
-    for(ClientList::iterator it = m_clients.begin(); it != m_clients.end(); ++it) {
-        ((Service::Client*)(*it))->onDeactivation();
-    }
+    ClientList::Reader clients(m_clients);
+    clients.forEach([](Service::Client *client) { client->onDeactivation(); });
 }
 
 void Service::onActivation(bool /*requested*/)
 {
-    m_worker.post([](Service *service) {
-        uint8_t timeout_counter = (THUNDER_RPC_TIMEOUT / 250);
-        bool shouldForceQueryController = !service->shouldActivateOnCrash() || service->isServiceUnstable();
-        while(timeout_counter-- && !service->isActive(shouldForceQueryController))
-            usleep(250 * 1000);
-
-        if(service->isActive(!shouldForceQueryController)) {
-            service->initialize(false);
-            service->notifyClientsOfActivation();
-        } else {
-            TTSLOG_ERROR("Service couldn't be activated");
-        }
-    });
+    m_worker.post([](Service *service) { service->waitForActivation(THUNDER_RPC_TIMEOUT / ACTIVATION_POLL_INTERVAL); });
+}
+
+void Service::waitForActivation(int attempts)
+{
+    // Polls through delayed jobs rather than sleeping, to leave the lane to the other services
+    bool shouldForceQueryController = !shouldActivateOnCrash() || isServiceUnstable();
+    if(attempts > 0 && !isActive(shouldForceQueryController)) {
+        m_worker.postAfter(std::chrono::milliseconds(ACTIVATION_POLL_INTERVAL), [attempts](Service *service) {
+            service->waitForActivation(attempts - 1);
+        });
+        return;
+    }
+
+    if(isActive(!shouldForceQueryController)) {
+        initialize(false);
+        notifyClientsOfActivation();
+    } else {
+        TTSLOG_ERROR("Service couldn't be activated");
+    }
 }
 
 bool Service::lastSessionWasHealthy()
@@ -188,7 +164,10 @@ bool Service::isServiceUnstable()
 
 void Service::onDeactivation(bool requested)
 {
-    m_eventsRegistered.clear(); // To avoid attempts to unregistering event handlers
+    {
+        std::lock_guard<std::mutex> lock(m_eventsMutex);
+        m_eventsRegistered.clear(); // To avoid attempts to unregistering event handlers
+    }
     uninitialize();
     notifyClientsOfDeactivation();
 
@@ -243,19 +222,18 @@ void Service::OnPluginStateChange(const JsonObject &params)
 void Service::installStateChangeHandler()
 {
     std::call_once(m_installStateChangeHandler, [this]() {
-        m_worker.post([](Service *service) {
-            int attempt = 0;
-            while(++attempt <= STATE_CHANGE_HANDLER_INSTALLATION_FAILURE_THRESHOLD) {
-                auto result = controller(service->m_tokenPayload)->Subscribe<JsonObject>(THUNDER_RPC_TIMEOUT, _T("statechange"), OnPluginStateChange);
-                TTSLOG_INFO("%s to \"statechange\" event from \"controller\"", (result == Core::ERROR_NONE) ? "Subscribed" : "Couldn't subscribe");
-                if(result == Core::ERROR_NONE)
-                    break;
-                sleep(1);
-            }
-        });
+        m_worker.post([](Service *service) { service->subscribeStateChange(1); });
     });
 }
 
+void Service::subscribeStateChange(int attempt)
+{
+    auto result = controller(m_tokenPayload)->Subscribe<JsonObject>(THUNDER_RPC_TIMEOUT, _T("statechange"), OnPluginStateChange);
+    TTSLOG_INFO("%s to \"statechange\" event from \"controller\"", (result == Core::ERROR_NONE) ? "Subscribed" : "Couldn't subscribe");
+    if(result != Core::ERROR_NONE && attempt < STATE_CHANGE_HANDLER_INSTALLATION_FAILURE_THRESHOLD)
+        m_worker.postAfter(std::chrono::seconds(1), [attempt](Service *service) { service->subscribeStateChange(attempt + 1); });
+}
+
 Service::Service(const char *callsign) : m_callSign(callsign ? callsign : ""), m_remoteObject(nullptr), m_active(false), m_activeQuerySuccess(false), m_envOverride(false), m_worker(this)
 {
     m_serviceListMutex.lock();
@@ -345,16 +323,16 @@ void Service::initialize(bool activateIfRequired)
         isActive(true);
     }
 
-    if(m_active && !m_remoteObject) {
+    if(m_active && !remoteObject()) {
         if(m_token.empty())
             m_token = Service::getSecurityToken(m_tokenPayload);
 
         if(m_token.empty())
-            m_remoteObject = std::make_shared<WPEFrameworkPlugin>(m_callSign, _T(""));
+            std::atomic_store(&m_remoteObject, std::make_shared<WPEFrameworkPlugin>(m_callSign, _T("")));
         else
-            m_remoteObject = std::make_shared<WPEFrameworkPlugin>(m_callSign, _T(""), false, m_token);
+            std::atomic_store(&m_remoteObject, std::make_shared<WPEFrameworkPlugin>(m_callSign, _T(""), false, m_token));
 
-        if(m_remoteObject)
+        if(remoteObject())
             TTSLOG_INFO("Successfully connected to remote object \"%s\"", m_callSign.c_str());
         else
             TTSLOG_ERROR("Couldn't connect to remote object \"%s\"", m_callSign.c_str());
@@ -365,17 +343,36 @@ void Service::uninitialize()
 {
     m_active = false;
 
-    while(m_eventsRegistered.size()) {
-        m_remoteObject->Unsubscribe(THUNDER_RPC_TIMEOUT, _T(m_eventsRegistered.front()));
-        m_eventsRegistered.pop_front();
+    auto remote = remoteObject();
+    StringList events;
+    {
+        std::lock_guard<std::mutex> lock(m_eventsMutex);
+        events.swap(m_eventsRegistered);
+    }
+    while(events.size()) {
+        if(remote)
+            remote->Unsubscribe(THUNDER_RPC_TIMEOUT, _T(events.front()));
+        events.pop_front();
     }
 
-    m_remoteObject = nullptr;
+    std::atomic_store(&m_remoteObject, std::shared_ptr<WPEFrameworkPlugin>());
+}
+
+void Service::unsubscribe(std::string event)
+{
+    auto remote = remoteObject();
+    if(remote)
+        remote->Unsubscribe(THUNDER_RPC_TIMEOUT, _T(event));
+    {
+        std::lock_guard<std::mutex> lock(m_eventsMutex);
+        m_eventsRegistered.remove(event);
+    }
+    TTSLOG_INFO("Unsubscribed from \"%s\" event from \"%s\"", event.c_str(), m_callSign.c_str());
 }
 
 bool Service::initialized()
 {
-    return m_remoteObject != nullptr;
+    return remoteObject() != nullptr;
 }
 
 void Service::registerClient(Service::Client *client)
@@ -383,9 +380,7 @@ void Service::registerClient(Service::Client *client)
     if(!client)
         return;
 
-    std::unique_lock<std::mutex> lock(m_mutex);
-    if(std::find(m_clients.begin(), m_clients.end(), client) == m_clients.end())
-        m_clients.push_back(client);
+    m_clients.add(client);
 }
 
 void Service::unregisterClient(Service::Client *client)
@@ -393,19 +388,16 @@ void Service::unregisterClient(Service::Client *client)
     if(!client)
         return;
 
-    std::unique_lock<std::mutex> lock(m_mutex);
-    ClientList::iterator it = std::find(m_clients.begin(), m_clients.end(), client);
-    if(it != m_clients.end())
-        m_clients.erase(it);
+    m_clients.remove(client);
 }
 
 bool Service::get(std::string method, Core::JSON::String &response)
 {
-    auto remote = m_remoteObject;
-    if(!m_remoteObject)
+    auto remote = remoteObject();
+    if(!remote)
         return false;
 
-    auto ret = m_remoteObject->Get<Core::JSON::String>(THUNDER_RPC_TIMEOUT, method, response);
+    auto ret = remote->Get<Core::JSON::String>(THUNDER_RPC_TIMEOUT, method, response);
     if(ret == Core::ERROR_NONE)
         return true;
 
@@ -415,14 +407,64 @@ bool Service::get(std::string method, Core::JSON::String &response)
 
 bool Service::invoke(std::string method, JsonObject &request, JsonObject &response)
 {
-    auto remote = m_remoteObject;
-    if(!m_remoteObject)
+    // The reply is matched by its id on the link, so only this caller waits for it;
+    // requests from other threads keep flowing on the same link meanwhile
+    struct Reply {
+        JsonObject response;
+        bool success { false };
+        bool received { false };
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
+    auto reply = std::make_shared<Reply>();
+    bool dispatched = invokeAsync(method, request, [reply](bool success, const JsonObject &response) {
+        std::lock_guard<std::mutex> lock(reply->mutex);
+        reply->response = response;
+        reply->success = success;
+        reply->received = true;
+        reply->condition.notify_one();
+    });
+
+    if(!dispatched)
         return false;
 
-    auto ret = m_remoteObject->Invoke<JsonObject, JsonObject>(THUNDER_RPC_TIMEOUT, method, request, response);
-    if(ret == Core::ERROR_NONE && response["success"].Boolean() == true)
-        return true;
+    std::unique_lock<std::mutex> lock(reply->mutex);
+    if(!reply->condition.wait_for(lock, std::chrono::milliseconds(THUNDER_RPC_TIMEOUT), [reply] { return reply->received; })) {
+        TTSLOG_ERROR("Calling \"%s\" method on \"%s\" timed out", method.c_str(), m_callSign.c_str());
+        return false;
+    }
+
+    response = reply->response;
+    return reply->success;
+}
+
+bool Service::invokeAsync(std::string method, const JsonObject &request, ResponseHandler handler)
+{
+    auto remote = remoteObject();
+    if(!remote)
+        return false;
+
+    std::function<void (const JsonObject&, const Core::JSONRPC::Error*)> callback =
+        [this, method, handler](const JsonObject &response, const Core::JSONRPC::Error *error) {
+            bool success = (error == nullptr && response["success"].Boolean() == true);
+            if(!success)
+                logFailure(method, response, error ? Core::ERROR_GENERAL : Core::ERROR_NONE);
+            if(handler)
+                handler(success, response);
+        };
+
+    auto ret = remote->Dispatch<JsonObject>(THUNDER_RPC_TIMEOUT, method, request, callback);
+    if(ret != Core::ERROR_NONE) {
+        TTSLOG_ERROR("Dispatching \"%s\" method on \"%s\" failed, error=%d", method.c_str(), m_callSign.c_str(), ret);
+        return false;
+    }
+
+    return true;
+}
 
+void Service::logFailure(const std::string &method, const JsonObject &response, uint32_t ret)
+{
     if(response.HasLabel("error")) {
         JsonObject error;
         error.FromString(response["error"].String());
@@ -431,8 +473,43 @@ bool Service::invoke(std::string method, JsonObject &request, JsonObject &respon
     } else {
         TTSLOG_ERROR("Calling \"%s\" method on \"%s\" failed, error=%d", method.c_str(), m_callSign.c_str(), ret);
     }
+}
 
-    return false;
+bool Service::invokeBatch(std::string method, std::vector<JsonObject> &requests, std::vector<JsonObject> &responses, std::vector<bool> &results)
+{
+    // Shared with the reply handlers, which may outlive this call on timeout
+    struct Batch {
+        Batch(size_t count) : responses(count), results(count, false), pending(count) {}
+        std::vector<JsonObject> responses;
+        std::vector<bool> results;
+        size_t pending;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
+    auto batch = std::make_shared<Batch>(requests.size());
+    for(size_t i = 0; i < requests.size(); i++) {
+        bool dispatched = invokeAsync(method, requests[i], [batch, i](bool success, const JsonObject &response) {
+            std::lock_guard<std::mutex> lock(batch->mutex);
+            batch->responses[i] = response;
+            batch->results[i] = success;
+            if(--batch->pending == 0)
+                batch->condition.notify_one();
+        });
+
+        if(!dispatched) {
+            std::lock_guard<std::mutex> lock(batch->mutex);
+            --batch->pending;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    if(!batch->condition.wait_for(lock, std::chrono::milliseconds(THUNDER_RPC_TIMEOUT), [batch] { return batch->pending == 0; }))
+        TTSLOG_ERROR("%zu of %zu \"%s\" requests on \"%s\" timed out", batch->pending, requests.size(), method.c_str(), m_callSign.c_str());
+
+    responses = batch->responses;
+    results = batch->results;
+    return std::find(results.begin(), results.end(), false) == results.end();
 }
 
 } // namespace TTSThunderClient
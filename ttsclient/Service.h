@@ -26,13 +26,20 @@
 #include <WPEFramework/core/core.h>
 #include <WPEFramework/plugins/Service.h>
 #undef LOG
+#include <condition_variable>
+#include <functional>
 #include <thread>
+#include <memory>
 #include <mutex>
+#include <vector>
 #include <list>
 
 #include <unistd.h>
 #include <sys/syscall.h>
 
+#include "ClientSnapshotList.h"
+#include "Executor.h"
+
 #ifndef _LOG_INFO
 #define _LOG_INFO(fmt, ...) do { \
     printf("000000-00:00:00.000 [INFO] [tid=%ld] %s:%s:%d " fmt "\n", \
@@ -60,30 +67,26 @@ public:
         virtual void onActivation() {}
         virtual void onDeactivation() {}
     };
-    using ClientList = std::list<Service::Client*>;
+    using ClientList = TTS::ClientSnapshotList<Service::Client>;
+    using ResponseHandler = std::function<void (bool success, const JsonObject &response)>;
 
     // To activate & initialize on service crash
     // Those should be done on a separate thread other than
-    // the callback thread
+    // the callback thread, they block so they run on the
+    // executor's blocking lane
     struct AsyncWorker {
         using Task = std::function<void (Service *service)>;
-        using TaskList = std::list<Task>;
 
-        AsyncWorker(Service *service) : m_service(service), m_thread(nullptr) {}
+        AsyncWorker(Service *service) : m_service(service), m_strand(TTS::Executor::Blocking()) {}
         ~AsyncWorker() { cleanup(); }
 
         void post(Task task);
+        void postAfter(std::chrono::milliseconds delay, Task task);
         void cleanup();
 
         private:
         Service *m_service;
-        std::thread *m_thread;
-
-        bool m_running;
-        TaskList m_tasklist;
-        std::mutex m_mutex;
-
-        friend class std::thread;
+        TTS::Executor::Strand m_strand;
     };
 
 public:
@@ -99,13 +102,21 @@ public:
     virtual void uninitialize();
     virtual bool initialized();
 
-    void registerClient(Client *client);
-    void unregisterClient(Client *client);
+    virtual void registerClient(Client *client);
+    virtual void unregisterClient(Client *client);
     bool get(std::string method, Core::JSON::String &response);
     bool invoke(std::string method, JsonObject &request, JsonObject &response);
+    // Sends the request without waiting for its reply. The link matches the reply
+    // by its JSON-RPC id and calls "handler" on the link's thread, so any number of
+    // requests from any number of threads can be outstanding at the same time.
+    bool invokeAsync(std::string method, const JsonObject &request, ResponseHandler handler);
+    // Pipelined variant of invoke(), all the requests are sent back to back and
+    // the replies are collected afterwards. Returns true only if all succeeded.
+    bool invokeBatch(std::string method, std::vector<JsonObject> &requests, std::vector<JsonObject> &responses, std::vector<bool> &results);
 
     template<typename handler_t, typename object_t>
     bool subscribe(std::string event, handler_t handler, object_t object);
+    void unsubscribe(std::string event);
 
     // service crash handling
     virtual bool shouldActivateOnCrash() { return false; }
@@ -117,9 +128,15 @@ protected:
     virtual void onActivation(bool requested);
     virtual void onDeactivation(bool requested);
 
+    // The remote object is swapped on (de)activation while requests are in
+    // flight on other threads, hence it is always accessed atomically
+    std::shared_ptr<WPEFrameworkPlugin> remoteObject() const { return std::atomic_load(&m_remoteObject); }
+    void logFailure(const std::string &method, const JsonObject &response, uint32_t error);
+
     const std::string m_callSign;
     std::shared_ptr<WPEFrameworkPlugin> m_remoteObject;
     StringList m_eventsRegistered;
+    std::mutex m_eventsMutex;
     ClientList m_clients;
     std::mutex m_mutex;
     bool m_active;
@@ -136,11 +153,13 @@ protected:
     bool isServiceUnstable();
     std::list<TimePoint> m_crashTimeStamps;
 
+    void waitForActivation(int attempts);
     void notifyClientsOfActivation();
     void notifyClientsOfDeactivation();
 
     // Services
     void installStateChangeHandler();
+    void subscribeStateChange(int attempt);
     static std::once_flag m_installStateChangeHandler;
     static void OnPluginStateChange(const JsonObject &params);
 
@@ -154,14 +173,15 @@ template<typename handler_t, typename object_t>
 bool Service::subscribe(std::string event, handler_t handler, object_t object)
 {
     // This protects the WPEFrameworkPlugin instance untill the function is complete
-    auto remote = m_remoteObject;
+    auto remote = remoteObject();
 
-    if(!m_remoteObject)
+    if(!remote)
         return false;
 
-    auto result = m_remoteObject->Subscribe<JsonObject>(THUNDER_RPC_TIMEOUT, _T(event), handler, object);
+    auto result = remote->Subscribe<JsonObject>(THUNDER_RPC_TIMEOUT, _T(event), handler, object);
     _LOG_INFO("%s to \"%s\" event from \"%s\"", (result == Core::ERROR_NONE) ? "Subscribed" : "Couldn't subscribe", event.c_str(), m_callSign.c_str());
     if(result == Core::ERROR_NONE) {
+        std::lock_guard<std::mutex> lock(m_eventsMutex);
         m_eventsRegistered.push_back(event);
         return true;
     }
@@ -0,0 +1,1326 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "SessionTable.h"
+#include "ResourceArbiter.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace TTS {
+
+// Terminal events which came in before the speak reply, remembered so that the
+// speech doesn't look pending forever
+#define MAX_UNOWNED_SPEECHES 16
+
+// Chunks shorter than this are not cut at a sentence end, sentences are also
+// cut at their clauses once longer than CHUNK_CLAUSE_LENGTH
+#define CHUNK_MIN_LENGTH 24
+#define CHUNK_CLAUSE_LENGTH 80
+
+// Streamed text is read by STREAM_READ_SIZE, text without any boundary is cut
+// once STREAM_MAX_CHUNK long
+#define STREAM_READ_SIZE 1024
+#define STREAM_MAX_CHUNK 4096
+
+// Splits the text after sentence (. ! ?) and clause (, ; :) punctuation followed by
+// a space, SSML is not split
+static std::vector<std::string> splitText(const std::string &text) {
+    std::vector<std::string> chunks;
+    size_t start = text.find_first_not_of(" \t\r\n");
+    if(start == std::string::npos || text[start] == '<') {
+        chunks.push_back(text);
+        return chunks;
+    }
+
+    size_t last = start;
+    for(size_t i = start; i + 1 < text.size(); i++) {
+        if(!isspace((unsigned char)text[i + 1]))
+            continue;
+
+        char c = text[i];
+        size_t length = i + 1 - start;
+        bool sentence = (c == '.' || c == '!' || c == '?') && length >= CHUNK_MIN_LENGTH;
+        bool clause = (c == ',' || c == ';' || c == ':') && length >= CHUNK_CLAUSE_LENGTH;
+        if(!sentence && !clause)
+            continue;
+
+        chunks.push_back(text.substr(start, length));
+        last = start;
+        start = text.find_first_not_of(" \t\r\n", i + 1);
+        if(start == std::string::npos)
+            return chunks;
+        i = start - 1;
+    }
+
+    // A short tail stays with the previous chunk
+    if(!chunks.empty() && text.size() - start < CHUNK_MIN_LENGTH)
+        chunks.back() = text.substr(last);
+    else
+        chunks.push_back(text.substr(start));
+    return chunks;
+}
+
+SessionTable::SessionTable(Submitter submitter, Canceller canceller) :
+    m_submitter(submitter),
+    m_canceller(canceller),
+    m_playing(0),
+    m_playingLength(0),
+    m_playingPaused(false),
+    m_nextSessionId(1),
+    m_preempting(0),
+    m_pumping(false),
+    m_closed(false),
+    m_nextCheck(std::chrono::steady_clock::time_point::max()),
+    m_watcher(Executor::Blocking()),
+    m_reader(Executor::Blocking()) {
+    ResourceArbiter::Instance().registerTable(this);
+}
+
+SessionTable::~SessionTable() {
+    ResourceArbiter::Instance().unregisterTable(this);
+    m_reader.stop(true);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+
+    // Drops the scheduled check, or waits for the one in progress
+    m_watcher.stop(true);
+}
+
+SessionTable::SessionPtr SessionTable::create(uint32_t appId, const std::string &appName, TTSSessionCallback *callback) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto app = m_appSessions.find(appId);
+    if(app != m_appSessions.end()) {
+        SessionPtr session = m_sessions[app->second];
+        session->callback = callback;
+        TTSLOG_INFO("Session %u of app %u reused", session->id, appId);
+        return session;
+    }
+
+    // Session ids are never reused, 0 stands for "no session"
+    uint32_t id = m_nextSessionId++;
+    if(!m_nextSessionId)
+        m_nextSessionId = 1;
+
+    SessionPtr session = std::make_shared<Session>(id, appId, appName, callback);
+    Session *raw = session.get();
+    session->speeches.setEvictionHandler([this, raw](uint32_t clientid, uint32_t serviceid) {
+        raw->states.remove(clientid);
+        forget(raw, clientid, serviceid);
+    });
+
+    m_sessions.emplace(id, session);
+    m_appSessions.emplace(appId, id);
+    TTSLOG_INFO("Session %u created for app %u (%s)", id, appId, appName.c_str());
+    return session;
+}
+
+bool SessionTable::destroy(uint32_t sessionId) {
+    SessionPtr session;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_sessions.find(sessionId);
+        if(it == m_sessions.end())
+            return false;
+
+        session = it->second;
+        m_sessions.erase(it);
+        m_appSessions.erase(session->appId);
+
+        // Speeches being submitted (no service id yet) are dropped by their submitter
+        for(auto speech = m_inflight.begin(); speech != m_inflight.end();) {
+            auto next = std::next(speech);
+            if(speech->session == session && speech->serviceid) {
+                m_speechOwners.erase(speech->serviceid);
+                m_inflight.erase(speech);
+            }
+            speech = next;
+        }
+        m_held.remove_if([&session](const Scheduled &speech) { return speech.session == session; });
+        m_queued.remove_if([&session](const Scheduled &speech) { return speech.session == session; });
+    }
+
+    session->callback = nullptr;
+    session->duplicates.clear();
+    ResourceArbiter::Instance().sessionDestroyed(session->appId);
+
+    SpeechIdIndex::Counters counters = session->speeches.counters();
+    TTSLOG_INFO("Session %u destroyed, speech ids added=%llu, duplicates=%llu, removed=%llu, evicted=%llu, expired=%llu, misses=%llu",
+        sessionId, (unsigned long long)counters.added, (unsigned long long)counters.duplicates, (unsigned long long)counters.removed,
+        (unsigned long long)counters.evicted, (unsigned long long)counters.expired, (unsigned long long)counters.misses);
+    return true;
+}
+
+SessionTable::SessionPtr SessionTable::find(uint32_t sessionId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_sessions.find(sessionId);
+    return (it != m_sessions.end()) ? it->second : nullptr;
+}
+
+SessionTable::SessionPtr SessionTable::findForApp(uint32_t appId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto app = m_appSessions.find(appId);
+    if(app == m_appSessions.end())
+        return nullptr;
+    return m_sessions[app->second];
+}
+
+std::vector<SessionTable::SessionPtr> SessionTable::sessions() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<SessionPtr> sessions;
+    sessions.reserve(m_sessions.size());
+    for(auto &session : m_sessions)
+        sessions.push_back(session.second);
+    return sessions;
+}
+
+uint32_t SessionTable::eventInterest() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t events = 0;
+    if(!m_closed) {
+        for(auto &session : m_sessions)
+            events |= session.second->eventMask;
+    }
+    return events;
+}
+
+TTS_Error SessionTable::speak(const SessionPtr &session, SpeechData &data, uint32_t *serviceSpeechId) {
+    if(serviceSpeechId)
+        *serviceSpeechId = 0;
+
+    if(!ResourceArbiter::Instance().isActive(session->appId)) {
+        TTSLOG_WARNING("App %u doesn't hold the resource, can't speak", session->appId);
+        return TTS_RESOURCE_BUSY;
+    }
+
+    TTS_Error error = TTS_OK;
+    bool deduplicated = (session->duplicates.policy() != DUPLICATE_SPEAK);
+    if(deduplicated && suppressDuplicate(session, data, serviceSpeechId, error))
+        return error;
+
+    SpeechPriority priority = priorityOf(session, data);
+    Scheduled scheduled = {session, data, priority, 0, nullptr};
+    if(session->chunked) {
+        std::vector<std::string> chunks = splitText(data.text);
+        if(chunks.size() > 1) {
+            scheduled.utterance = std::make_shared<Utterance>(session, data, priority);
+            scheduled.utterance->chunks.assign(chunks.begin() + 1, chunks.end());
+            scheduled.utterance->outstanding = 1;
+            scheduled.data.text = chunks.front();
+            TTSLOG_INFO("Speech with clientid-%d is spoken in %zu chunks", data.id, chunks.size());
+        }
+    }
+
+    if(session->speakAhead && queueAhead(scheduled))
+        error = TTS_OK;
+    else
+        error = schedule(std::move(scheduled), serviceSpeechId);
+    if(deduplicated && error == TTS_OK)
+        session->duplicates.record(data.text, data.id);
+    if(data.hasDeadline() && error == TTS_OK)
+        watchDeadlines();
+    return error;
+}
+
+bool SessionTable::suppressDuplicate(const SessionPtr &session, SpeechData &data, uint32_t *serviceSpeechId, TTS_Error &error) {
+    uint32_t original = session->duplicates.match(data.text, session->states);
+    if(!original || original == data.id)
+        return false;
+
+    if(session->duplicates.policy() == DUPLICATE_DROP) {
+        session->duplicates.dropped();
+        TTSLOG_INFO("Dropped speech with clientid-%d, repeat of clientid-%d", data.id, original);
+        error = TTS_SPEECH_DUPLICATE;
+        return true;
+    }
+
+    if(!session->duplicates.merge(original, data.id, session->states))
+        return false;
+
+    if(serviceSpeechId)
+        *serviceSpeechId = session->speeches.getServiceId(original);
+    TTSLOG_INFO("Merged speech with clientid-%d into clientid-%d", data.id, original);
+    error = TTS_OK;
+    return true;
+}
+
+TTS_Error SessionTable::speakStream(const SessionPtr &session, SpeechData &data, TextSource &source) {
+    if(!ResourceArbiter::Instance().isActive(session->appId)) {
+        TTSLOG_WARNING("App %u doesn't hold the resource, can't speak", session->appId);
+        return TTS_RESOURCE_BUSY;
+    }
+
+    SpeechPriority priority = priorityOf(session, data);
+    UtterancePtr utterance = std::make_shared<Utterance>(session, data, priority);
+    utterance->source = &source;
+    utterance->streaming = true;
+    fill(*utterance);
+
+    Scheduled scheduled = {session, utterance->data, priority, 0, utterance};
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(utterance->chunks.empty()) {
+            TTSLOG_ERROR("Nothing to speak for clientid-%d", data.id);
+            return TTS_FAIL;
+        }
+        scheduled.data.text = std::move(utterance->chunks.front());
+        utterance->chunks.pop_front();
+        utterance->outstanding = 1;
+    }
+
+    TTSLOG_INFO("Speech with clientid-%d is streamed", data.id);
+    TTS_Error error = schedule(std::move(scheduled), nullptr);
+    if(error == TTS_OK && utterance->streaming)
+        prefetch(utterance);
+    if(data.hasDeadline() && error == TTS_OK)
+        watchDeadlines();
+    return error;
+}
+
+TTS_Error SessionTable::schedule(Scheduled &&scheduled, uint32_t *serviceSpeechId) {
+    SessionPtr session = scheduled.session;
+    uint32_t clientSpeechId = scheduled.data.id;
+    SpeechPriority priority = scheduled.priority;
+    if(isExpired(scheduled, std::chrono::steady_clock::now())) {
+        TTSLOG_WARNING("Speech with clientid-%d is past its deadline", clientSpeechId);
+        return TTS_SPEECH_EXPIRED;
+    }
+
+    std::vector<std::pair<SessionPtr, uint32_t>> withdrawn;
+    uint32_t interrupted = 0;
+    bool pumpAfter = false;
+    ScheduledList::iterator speech;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_closed)
+            return TTS_FAIL;
+
+        // Held speeches of the same or higher priority go first
+        bool blocked = !m_held.empty() && m_held.front().priority >= priority;
+        if(blocked || (priority == SPEECH_PRIORITY_LOW && !m_inflight.empty())) {
+            session->states.add(clientSpeechId);
+            hold(std::move(scheduled));
+            TTSLOG_INFO("Held speech with clientid-%d, priority-%d", clientSpeechId, priority);
+            return TTS_OK;
+        }
+
+        // Cancel the lower priority speech in progress and take the other lower priority
+        // ones back from the service, so that this one is next. Those still being submitted
+        // are left alone. The requeued ones are resubmitted right after this one, a running
+        // pump stops until then.
+        if(priority == SPEECH_PRIORITY_HIGH) {
+            ScheduledList requeued;
+            for(auto it = m_inflight.begin(); it != m_inflight.end();) {
+                auto next = std::next(it);
+                if(it->priority < priority && it->serviceid) {
+                    if(it->serviceid == m_playing) {
+                        interrupted = it->serviceid;
+                    } else {
+                        withdrawn.push_back({it->session, it->serviceid});
+                        m_speechOwners.erase(it->serviceid);
+                        it->serviceid = 0;
+                        requeued.splice(requeued.end(), m_inflight, it);
+                    }
+                }
+                it = next;
+            }
+
+            // Ahead of the other held speeches of their priority, in their original order
+            while(!requeued.empty()) {
+                SpeechPriority requeuedPriority = requeued.back().priority;
+                auto pos = std::find_if(m_held.begin(), m_held.end(), [requeuedPriority](const Scheduled &held) { return held.priority <= requeuedPriority; });
+                m_held.splice(pos, requeued, std::prev(requeued.end()));
+            }
+
+            if(!withdrawn.empty()) {
+                ++m_preempting;
+                pumpAfter = true;
+            }
+        }
+
+        speech = m_inflight.insert(m_inflight.end(), std::move(scheduled));
+    }
+
+    // Withdrawn speeches are no longer owned, their cancel events are ignored
+    for(auto &speech : withdrawn) {
+        speech.first->speeches.removeServiceId(speech.second);
+        m_canceller(speech.second);
+    }
+
+    if(interrupted) {
+        TTSLOG_INFO("Cancelling speech with serviceid-%u for clientid-%d", interrupted, clientSpeechId);
+        m_canceller(interrupted);
+    }
+
+    TTS_Error error = submit(speech, serviceSpeechId);
+    if(pumpAfter) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            pumpAfter = (--m_preempting == 0) && !m_pumping;
+            if(pumpAfter)
+                m_pumping = true;
+        }
+        if(pumpAfter)
+            runPump();
+    }
+    return error;
+}
+
+bool SessionTable::canBatch(const SessionPtr &session, const std::vector<SpeechData> &data) {
+    // Speak-ahead sessions keep their speeches back past the depth, the speeches are
+    // scheduled one by one
+    if(session->preemptive || session->chunked || session->speakAhead || session->duplicates.policy() != DUPLICATE_SPEAK ||
+       !ResourceArbiter::Instance().isActive(session->appId))
+        return false;
+
+    // The deadlines are watched by the scheduler
+    for(auto &speech : data) {
+        if(speech.priority != SPEECH_PRIORITY_NORMAL || speech.hasDeadline())
+            return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_closed && (m_held.empty() || m_held.front().priority < SPEECH_PRIORITY_NORMAL);
+}
+
+TTS_Error SessionTable::speakEach(const SessionPtr &session, std::vector<SpeechData> &data, std::vector<TTS_Error> &results) {
+    TTS_Error ret = TTS_OK;
+    results.assign(data.size(), TTS_FAIL);
+    for(size_t i = 0; i < data.size(); i++) {
+        results[i] = speak(session, data[i], nullptr);
+        if(results[i] != TTS_OK)
+            ret = results[i];
+    }
+    return ret;
+}
+
+size_t SessionTable::addSpeeches(const SessionPtr &session, const std::vector<Submission> &speeches) {
+    SpeechIdIndex::IdList ids;
+    for(auto &speech : speeches) {
+        if(speech.serviceid)
+            ids.push_back({speech.data.id, speech.serviceid});
+    }
+
+    // The index may call back into forget(), it is never used under m_mutex
+    size_t added = session->speeches.add(ids);
+    for(auto &id : ids)
+        session->states.add(id.first);
+
+    if(ids.size() > 0)
+        session->lastSpeechId = ids.back().second;
+
+    std::vector<const Submission*> ended;
+    std::vector<uint32_t> revoked;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_sessions.find(session->id) == m_sessions.end())
+            return added;
+        // The resource was handed over while the batch was submitted, the arbiter
+        // couldn't see these speeches then
+        bool active = ResourceArbiter::Instance().isActive(session->appId);
+        for(auto &speech : speeches) {
+            if(!speech.serviceid)
+                continue;
+            if(takeUnowned(speech.serviceid)) {
+                ended.push_back(&speech);
+                continue;
+            }
+            m_speechOwners[speech.serviceid] = m_inflight.insert(m_inflight.end(), {session, speech.data, SPEECH_PRIORITY_NORMAL, speech.serviceid, nullptr});
+            if(!active)
+                revoked.push_back(speech.serviceid);
+        }
+    }
+
+    // Ended before the reply came in
+    for(auto speech : ended) {
+        session->speeches.removeServiceId(speech->serviceid);
+        session->states.remove(speech->data.id);
+    }
+
+    for(auto serviceid : revoked) {
+        TTSLOG_WARNING("App %u lost the resource, cancelling speech with serviceid-%u", session->appId, serviceid);
+        m_canceller(serviceid);
+    }
+    return added;
+}
+
+void SessionTable::clearHeld(const SessionPtr &session) {
+    ScheduledList dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for(auto it = m_held.begin(); it != m_held.end();) {
+            auto next = std::next(it);
+            if(it->session == session)
+                dropped.splice(dropped.end(), m_held, it);
+            it = next;
+        }
+        for(auto it = m_queued.begin(); it != m_queued.end();) {
+            auto next = std::next(it);
+            if(it->session == session)
+                dropped.splice(dropped.end(), m_queued, it);
+            it = next;
+        }
+    }
+    drop(dropped);
+}
+
+bool SessionTable::withdraw(const SessionPtr &session, uint32_t serviceid) {
+    ScheduledList withdrawn;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto owner = m_speechOwners.find(serviceid);
+        if(owner == m_speechOwners.end() || owner->second->session != session)
+            return false;
+
+        auto speech = owner->second;
+        if(serviceid == m_playing || speech->utterance)
+            return false;
+
+        // No longer owned, its cancel event is ignored
+        m_speechOwners.erase(owner);
+        withdrawn.splice(withdrawn.end(), m_inflight, speech);
+    }
+
+    m_canceller(serviceid);
+    uint32_t clientSpeechId = withdrawn.front().data.id;
+    TTSLOG_INFO("Withdrew speech with clientid-%d, serviceid-%u", clientSpeechId, serviceid);
+    session->speeches.removeServiceId(serviceid);
+    session->states.remove(clientSpeechId);
+    notify(session, SpeechCancel, clientSpeechId);
+    return true;
+}
+
+void SessionTable::reset() {
+    ScheduledList dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_inflight.remove_if([](const Scheduled &speech) { return speech.serviceid != 0; });
+        m_speechOwners.clear();
+        m_unowned.clear();
+        m_playing = 0;
+        dropped.swap(m_held);
+        dropped.splice(dropped.end(), m_queued);
+    }
+    drop(dropped);
+
+    // The repeats merged into the speeches the service dropped would never be told
+    for(auto &session : sessions())
+        session->duplicates.clear();
+}
+
+std::vector<uint32_t> SessionTable::submittedSpeeches(uint32_t appId) {
+    std::vector<uint32_t> speeches;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto app = m_appSessions.find(appId);
+    if(app == m_appSessions.end())
+        return speeches;
+
+    for(auto &speech : m_inflight) {
+        if(speech.session->id == app->second && speech.serviceid)
+            speeches.push_back(speech.serviceid);
+    }
+    return speeches;
+}
+
+void SessionTable::close() {
+    ResourceArbiter::Instance().unregisterTable(this);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+    m_held.clear();
+    m_queued.clear();
+}
+
+void SessionTable::dispatch(SpeechEvent event, uint32_t serviceid) {
+    // Events after SpeechResume end the speech
+    bool terminal = (event > SpeechResume);
+
+    SessionPtr session;
+    bool wake = false;
+    uint32_t chunkSpeechId = 0;
+    ChunkProgress chunk;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto owner = m_speechOwners.find(serviceid);
+        if(owner == m_speechOwners.end()) {
+            if(terminal) {
+                m_unowned.push_back(serviceid);
+                if(m_unowned.size() > MAX_UNOWNED_SPEECHES)
+                    m_unowned.pop_front();
+            }
+            return;
+        }
+
+        session = owner->second->session;
+        track(event, serviceid, owner->second->data.text.size());
+        if(owner->second->utterance) {
+            chunkSpeechId = owner->second->data.id;
+            chunk = advance(owner->second, event);
+        }
+        if(terminal) {
+            m_inflight.erase(owner->second);
+            m_speechOwners.erase(owner);
+            wake = !m_held.empty();
+        }
+    }
+
+    if(chunk.utterance) {
+        carryOut(session, event, serviceid, chunkSpeechId, chunk);
+        if(wake)
+            pump();
+        if(terminal && session->speakAhead)
+            promote(session);
+        return;
+    }
+
+    uint32_t clientSpeechId = terminal ? session->speeches.removeServiceId(serviceid) : session->speeches.getClientId(serviceid);
+    if(clientSpeechId) {
+        switch(event) {
+            case SpeechStart: session->states.set(clientSpeechId, SPEECH_IN_PROGRESS); break;
+            case SpeechPause: session->states.set(clientSpeechId, SPEECH_PAUSED); break;
+            case SpeechResume: session->states.set(clientSpeechId, SPEECH_IN_PROGRESS); break;
+            default: session->states.remove(clientSpeechId); break;
+        }
+        notify(session, event, clientSpeechId);
+    }
+
+    if(wake)
+        pump();
+    if(terminal && session->speakAhead)
+        promote(session);
+}
+
+SpeechPriority SessionTable::priorityOf(const SessionPtr &session, const SpeechData &data) {
+    return session->preemptive ? SPEECH_PRIORITY_HIGH : data.priority;
+}
+
+void SessionTable::hold(Scheduled &&speech) {
+    SpeechPriority priority = speech.priority;
+    auto pos = std::find_if(m_held.begin(), m_held.end(), [this, priority, &speech](const Scheduled &held) {
+        return held.priority < priority || (held.priority == priority && isMoreUrgent(speech, held));
+    });
+    m_held.insert(pos, std::move(speech));
+}
+
+bool SessionTable::isMoreUrgent(const Scheduled &speech, const Scheduled &than) {
+    return speech.data.hasDeadline() && (!than.data.hasDeadline() || speech.data.deadline < than.data.deadline);
+}
+
+bool SessionTable::isExpired(const Scheduled &speech, std::chrono::steady_clock::time_point now) {
+    // The rest of an utterance which started is spoken through
+    return speech.data.hasDeadline() && now >= speech.data.deadline && !(speech.utterance && speech.utterance->started);
+}
+
+bool SessionTable::queueAhead(Scheduled &speech) {
+    SessionPtr session = speech.session;
+    uint32_t clientSpeechId = speech.data.id;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        bool waiting = std::any_of(m_queued.begin(), m_queued.end(), [&session](const Scheduled &queued) { return queued.session == session; });
+        if(m_closed || (!waiting && scheduledCount(session) <= session->speakAhead))
+            return false;
+
+        session->states.add(clientSpeechId);
+        auto pos = std::find_if(m_queued.begin(), m_queued.end(), [this, &speech](const Scheduled &queued) { return isMoreUrgent(speech, queued); });
+        m_queued.insert(pos, std::move(speech));
+    }
+
+    TTSLOG_INFO("Speech with clientid-%d waits to be spoken ahead", clientSpeechId);
+    // The speeches ahead may have ended meanwhile
+    promote(session);
+    return true;
+}
+
+void SessionTable::promote(const SessionPtr &session) {
+    while(1) {
+        ScheduledList next;
+        bool expired = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(m_closed)
+                return;
+
+            auto it = std::find_if(m_queued.begin(), m_queued.end(), [&session](const Scheduled &queued) { return queued.session == session; });
+            uint32_t depth = session->speakAhead;
+            if(it == m_queued.end() || (depth && scheduledCount(session) > depth))
+                return;
+            next.splice(next.end(), m_queued, it);
+            expired = isExpired(next.front(), std::chrono::steady_clock::now());
+        }
+
+        if(expired) {
+            drop(next, SpeechExpired);
+            continue;
+        }
+
+        if(!ResourceArbiter::Instance().isActive(session->appId)) {
+            TTSLOG_WARNING("App %u doesn't hold the resource, dropping speech with clientid-%d", session->appId, next.front().data.id);
+            drop(next);
+            continue;
+        }
+
+        UtterancePtr utterance = next.front().utterance;
+        uint32_t clientSpeechId = next.front().data.id;
+        TTS_Error error = schedule(std::move(next.front()), nullptr);
+        if(error != TTS_OK) {
+            TTSLOG_ERROR("Coudn't submit speech with clientid-%d", clientSpeechId);
+            if(!utterance || !utterance->ended.exchange(true)) {
+                if(utterance)
+                    session->speeches.removeClientId(clientSpeechId);
+                session->states.remove(clientSpeechId);
+                notify(session, (error == TTS_SPEECH_EXPIRED) ? SpeechExpired : SpeechCancel, clientSpeechId);
+            }
+        }
+    }
+}
+
+size_t SessionTable::scheduledCount(const SessionPtr &session) {
+    auto ofSession = [&session](const Scheduled &speech) { return speech.session == session; };
+    return std::count_if(m_inflight.begin(), m_inflight.end(), ofSession) + std::count_if(m_held.begin(), m_held.end(), ofSession);
+}
+
+void SessionTable::track(SpeechEvent event, uint32_t serviceid, size_t length) {
+    auto now = std::chrono::steady_clock::now();
+    switch(event) {
+        case SpeechStart:
+            m_playing = serviceid;
+            m_playingSince = now;
+            m_playingLength = length;
+            m_playingPaused = false;
+            break;
+        case SpeechPause:
+            m_playingPaused = true;
+            break;
+        case SpeechResume:
+            break;
+        default:
+            // Only the speeches spoken through tell the pace
+            if(serviceid == m_playing && event == SpeechComplete && !m_playingPaused)
+                m_predictor.observe(m_playingLength, std::chrono::duration_cast<DurationPredictor::Duration>(now - m_playingSince));
+            if(serviceid == m_playing)
+                m_playing = 0;
+            break;
+    }
+}
+
+void SessionTable::setSpeakAhead(const SessionPtr &session, uint32_t depth) {
+    session->speakAhead = depth;
+    promote(session);
+}
+
+void SessionTable::setSpeechRate(uint8_t rate) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_predictor.setRate(rate);
+}
+
+std::vector<SpeechEstimate> SessionTable::estimates(const SessionPtr &session) {
+    std::vector<SpeechEstimate> estimates;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto now = std::chrono::steady_clock::now();
+    DurationPredictor::Duration startsIn(0);
+    std::unordered_map<Utterance*, size_t> utterances;
+    auto add = [&](const Scheduled &speech, bool playing) {
+        DurationPredictor::Duration duration = m_predictor.predict(speech.data.text.size());
+        if(playing) {
+            auto elapsed = std::chrono::duration_cast<DurationPredictor::Duration>(now - m_playingSince);
+            duration = (elapsed < duration) ? duration - elapsed : DurationPredictor::Duration(0);
+        }
+
+        // The chunks of an utterance add up to one speech, the chunks not submitted yet
+        // are counted with its first one
+        bool first = !speech.utterance || utterances.find(speech.utterance.get()) == utterances.end();
+        if(first && speech.utterance) {
+            size_t length = 0;
+            for(auto &chunk : speech.utterance->chunks)
+                length += chunk.size();
+            if(length)
+                duration += m_predictor.predict(length);
+        }
+
+        if(speech.session == session) {
+            if(first) {
+                if(speech.utterance)
+                    utterances[speech.utterance.get()] = estimates.size();
+                estimates.push_back({speech.data.id, (uint32_t)startsIn.count(), (uint32_t)duration.count()});
+            } else {
+                estimates[utterances[speech.utterance.get()]].durationMs += duration.count();
+            }
+        } else if(first && speech.utterance) {
+            utterances[speech.utterance.get()] = 0;
+        }
+        startsIn += duration;
+    };
+
+    for(auto &speech : m_inflight)
+        add(speech, speech.serviceid && speech.serviceid == m_playing);
+    for(auto &speech : m_held)
+        add(speech, false);
+    for(auto &speech : m_queued)
+        add(speech, false);
+    return estimates;
+}
+
+bool SessionTable::takeUnowned(uint32_t serviceid) {
+    auto it = std::find(m_unowned.begin(), m_unowned.end(), serviceid);
+    if(it == m_unowned.end())
+        return false;
+    m_unowned.erase(it);
+    return true;
+}
+
+TTS_Error SessionTable::submit(ScheduledList::iterator speech, uint32_t *serviceSpeechId) {
+    // Until it has a service id the entry is only touched by this thread
+    SessionPtr session = speech->session;
+    UtterancePtr utterance = speech->utterance;
+    uint32_t serviceid = 0;
+    TTS_Error error = m_submitter(speech->data, serviceid);
+
+    // The utterance was cancelled meanwhile
+    if(utterance && utterance->ended && error == TTS_OK && serviceid) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_inflight.erase(speech);
+        }
+        m_canceller(serviceid);
+        if(serviceSpeechId)
+            *serviceSpeechId = serviceid;
+        return error;
+    }
+
+    bool registered = false;
+    if(error == TTS_OK && serviceid) {
+        // The next chunks of an utterance take the client speech id over once they start
+        bool duplicate = false;
+        if(!utterance || !session->speeches.getServiceId(speech->data.id)) {
+            duplicate = !session->speeches.add(speech->data.id, serviceid);
+            if(!duplicate)
+                session->states.add(speech->data.id);
+            registered = !duplicate;
+        }
+        session->lastSpeechId = serviceid;
+        TTSLOG_INFO("Requested speech with clientid-%d, serviceid-%d, is_duplicate_client_id=%d", speech->data.id, serviceid, duplicate);
+    }
+
+    uint32_t clientSpeechId = speech->data.id;
+    bool ended = false;
+    bool withdrawn = false;
+    bool revoked = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        bool tracked = (error == TTS_OK && serviceid && m_sessions.find(session->id) != m_sessions.end());
+        if(tracked && utterance && utterance->ended) {
+            // The utterance ended while this chunk was being registered
+            tracked = false;
+            withdrawn = true;
+        } else if(tracked && takeUnowned(serviceid)) {
+            // Ended before the reply came in, a chunk's end is taken as its completion
+            ended = true;
+            tracked = (utterance != nullptr);
+        }
+
+        if(tracked) {
+            speech->serviceid = serviceid;
+            m_speechOwners[serviceid] = speech;
+            if(speech->data.hasDeadline())
+                scheduleCheck(speech->data.deadline);
+            // The resource was handed over while it was submitted, the arbiter couldn't
+            // see this speech then. It is cancelled as any other speech of the app
+            revoked = !ResourceArbiter::Instance().isActive(session->appId);
+        } else {
+            m_inflight.erase(speech);
+        }
+    }
+
+    if(withdrawn) {
+        m_canceller(serviceid);
+        if(registered) {
+            session->speeches.removeServiceId(serviceid);
+            session->states.remove(clientSpeechId);
+        }
+    } else if(ended && utterance) {
+        dispatch(SpeechComplete, serviceid);
+    } else if(ended) {
+        session->speeches.removeServiceId(serviceid);
+        session->states.remove(clientSpeechId);
+    } else if(revoked) {
+        TTSLOG_WARNING("App %u lost the resource, cancelling speech with serviceid-%u", session->appId, serviceid);
+        m_canceller(serviceid);
+    }
+
+    if(serviceSpeechId)
+        *serviceSpeechId = serviceid;
+    return error;
+}
+
+void SessionTable::pump() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_pumping || m_closed)
+            return;
+        m_pumping = true;
+    }
+    runPump();
+}
+
+void SessionTable::runPump() {
+    while(1) {
+        ScheduledList::iterator speech;
+        ScheduledList expired;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            // Low priority speeches wait until nothing is pending at the service,
+            // all of them until the high priority ones preempting them are submitted
+            if(m_closed || m_held.empty() || m_preempting > 0 || (m_held.front().priority == SPEECH_PRIORITY_LOW && !m_inflight.empty())) {
+                m_pumping = false;
+                return;
+            }
+            if(isExpired(m_held.front(), std::chrono::steady_clock::now())) {
+                expired.splice(expired.end(), m_held, m_held.begin());
+            } else {
+                m_inflight.splice(m_inflight.end(), m_held, m_held.begin());
+                speech = std::prev(m_inflight.end());
+            }
+        }
+
+        if(!expired.empty()) {
+            drop(expired, SpeechExpired);
+            continue;
+        }
+
+        SessionPtr session = speech->session;
+        UtterancePtr utterance = speech->utterance;
+        uint32_t clientSpeechId = speech->data.id;
+
+        if(!ResourceArbiter::Instance().isActive(session->appId)) {
+            // Lost the resource while held
+            TTSLOG_WARNING("App %u doesn't hold the resource, dropping held speech with clientid-%d", session->appId, clientSpeechId);
+            ScheduledList dropped;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                dropped.splice(dropped.end(), m_inflight, speech);
+            }
+            drop(dropped);
+            continue;
+        }
+
+        if(submit(speech, nullptr) != TTS_OK) {
+            TTSLOG_ERROR("Coudn't submit held speech with clientid-%d", clientSpeechId);
+            if(!utterance || !utterance->ended.exchange(true)) {
+                if(utterance)
+                    session->speeches.removeClientId(clientSpeechId);
+                session->states.remove(clientSpeechId);
+                notify(session, SpeechCancel, clientSpeechId);
+            }
+        }
+    }
+}
+
+void SessionTable::drop(ScheduledList &speeches, SpeechEvent event) {
+    for(auto &speech : speeches) {
+        // An utterance is cancelled once, with its first dropped chunk
+        if(speech.utterance && speech.utterance->ended.exchange(true))
+            continue;
+
+        TTSLOG_INFO("Dropping %s speech with clientid-%d", (event == SpeechExpired) ? "expired" : "held", speech.data.id);
+        if(speech.utterance)
+            speech.session->speeches.removeClientId(speech.data.id);
+        speech.session->states.remove(speech.data.id);
+        notify(speech.session, event, speech.data.id);
+    }
+}
+
+void SessionTable::watchDeadlines() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    scheduleCheck(std::chrono::steady_clock::now());
+}
+
+void SessionTable::scheduleCheck(std::chrono::steady_clock::time_point due) {
+    // Only the earliest check is kept track of, a later one left pending is harmless
+    if(m_closed || due >= m_nextCheck)
+        return;
+
+    m_nextCheck = due;
+    auto delay = std::max(due - std::chrono::steady_clock::now(), std::chrono::steady_clock::duration::zero());
+    m_watcher.postAfter(delay, [this] { checkDeadlines(); });
+}
+
+void SessionTable::checkDeadlines() {
+    using Clock = std::chrono::steady_clock;
+    struct Expired {
+        SessionPtr session;
+        uint32_t clientSpeechId;
+        uint32_t serviceid;
+        UtterancePtr utterance;
+    };
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if(Clock::now() >= m_nextCheck)
+        m_nextCheck = Clock::time_point::max();
+
+    while(!m_closed) {
+        auto now = Clock::now();
+        Clock::time_point next = Clock::time_point::max();
+        ScheduledList dropped;
+        std::vector<Expired> cancelled;
+        std::vector<SessionPtr> sessions;
+
+        // Speeches at the service which haven't started, being submitted ones are
+        // looked at once they have their service id
+        for(auto it = m_inflight.begin(); it != m_inflight.end();) {
+            auto following = std::next(it);
+            bool started = (it->serviceid == m_playing) || (it->utterance && it->utterance->started);
+            if(it->serviceid && !started && it->data.hasDeadline()) {
+                if(isExpired(*it, now)) {
+                    cancelled.push_back({it->session, it->data.id, it->serviceid, it->utterance});
+                    m_speechOwners.erase(it->serviceid);
+                    m_inflight.erase(it);
+                } else {
+                    next = std::min(next, it->data.deadline);
+                }
+            }
+            it = following;
+        }
+
+        for(auto *list : {&m_held, &m_queued}) {
+            for(auto it = list->begin(); it != list->end();) {
+                auto following = std::next(it);
+                if(isExpired(*it, now))
+                    dropped.splice(dropped.end(), *list, it);
+                else if(it->data.hasDeadline())
+                    next = std::min(next, it->data.deadline);
+                it = following;
+            }
+        }
+
+        if(cancelled.empty() && dropped.empty()) {
+            if(next != Clock::time_point::max())
+                scheduleCheck(next);
+            break;
+        }
+
+        bool wake = !cancelled.empty() && !m_held.empty() && !m_pumping;
+        if(wake)
+            m_pumping = true;
+        lock.unlock();
+
+        for(auto &speech : cancelled) {
+            TTSLOG_INFO("Speech with clientid-%d, serviceid-%u didn't start before its deadline", speech.clientSpeechId, speech.serviceid);
+            m_canceller(speech.serviceid);
+            // The chunks of an utterance are withdrawn, the utterance expires once
+            if(speech.utterance && speech.utterance->ended.exchange(true))
+                continue;
+            if(speech.utterance)
+                speech.session->speeches.removeClientId(speech.clientSpeechId);
+            else
+                speech.session->speeches.removeServiceId(speech.serviceid);
+            speech.session->states.remove(speech.clientSpeechId);
+            notify(speech.session, SpeechExpired, speech.clientSpeechId);
+            if(speech.session->speakAhead)
+                sessions.push_back(speech.session);
+        }
+        drop(dropped, SpeechExpired);
+
+        if(wake)
+            runPump();
+        for(auto &session : sessions)
+            promote(session);
+        lock.lock();
+    }
+}
+
+SessionTable::ChunkProgress SessionTable::advance(ScheduledList::iterator chunk, SpeechEvent event) {
+    ChunkProgress progress = {chunk->utterance, false, false, false, false, {}};
+    Utterance &utterance = *chunk->utterance;
+    // Events of the other chunks of an utterance already over
+    if(utterance.ended)
+        return progress;
+
+    switch(event) {
+        case SpeechStart:
+            progress.notify = !utterance.started;
+            progress.repoint = true;
+            utterance.started = true;
+            progress.wantNext = (!utterance.chunks.empty() || utterance.streaming) && utterance.outstanding < 2 && !m_closed;
+            break;
+        case SpeechPause:
+        case SpeechResume:
+            progress.notify = true;
+            break;
+        case SpeechComplete:
+            // The next chunk is normally queued by now, unless the start event was missed
+            utterance.outstanding--;
+            if(!utterance.outstanding) {
+                if((utterance.chunks.empty() && !utterance.streaming) || m_closed)
+                    progress.notify = progress.ended = true;
+                else
+                    progress.wantNext = true;
+            }
+            break;
+        default:
+            utterance.outstanding--;
+            progress.notify = progress.ended = true;
+            break;
+    }
+
+    if(progress.ended) {
+        // The other chunks are withdrawn, their events are no longer owned
+        utterance.ended = true;
+        utterance.chunks.clear();
+        for(auto it = m_inflight.begin(); it != m_inflight.end();) {
+            auto next = std::next(it);
+            if(it != chunk && it->utterance == chunk->utterance && it->serviceid) {
+                progress.withdrawn.push_back(it->serviceid);
+                m_speechOwners.erase(it->serviceid);
+                m_inflight.erase(it);
+            }
+            it = next;
+        }
+        m_held.remove_if([&chunk](const Scheduled &speech) { return speech.utterance == chunk->utterance; });
+    }
+    return progress;
+}
+
+SessionTable::ScheduledList::iterator SessionTable::queueChunk(const UtterancePtr &utterance) {
+    Scheduled next = {utterance->session, utterance->data, utterance->priority, 0, utterance};
+    next.data.text = std::move(utterance->chunks.front());
+    utterance->chunks.pop_front();
+    utterance->outstanding++;
+    return m_inflight.insert(m_inflight.end(), std::move(next));
+}
+
+void SessionTable::fill(Utterance &utterance) {
+    std::lock_guard<std::mutex> reading(utterance.readMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(utterance.ended || !utterance.chunks.empty())
+            return;
+    }
+
+    // Only the text of the next chunks and the sentence being read are kept
+    std::vector<std::string> ready;
+    char buffer[STREAM_READ_SIZE];
+    bool streaming = utterance.streaming;
+    while(streaming && !utterance.ended) {
+        size_t length = utterance.source->read(buffer, sizeof(buffer));
+        if(!length) {
+            streaming = false;
+            if(utterance.text.find_first_not_of(" \t\r\n") != std::string::npos)
+                ready.push_back(std::move(utterance.text));
+            utterance.text.clear();
+            break;
+        }
+
+        utterance.text.append(buffer, length);
+        std::vector<std::string> pieces = splitText(utterance.text);
+        if(pieces.size() > 1) {
+            // The last piece may not be complete yet
+            utterance.text = std::move(pieces.back());
+            pieces.pop_back();
+            ready = std::move(pieces);
+            break;
+        }
+
+        if(utterance.text.size() >= STREAM_MAX_CHUNK) {
+            // No boundary, cut at a space and never inside a UTF-8 sequence
+            size_t cut = utterance.text.find_last_of(' ');
+            if(cut == std::string::npos || cut == 0) {
+                size_t end = utterance.text.size();
+                while(end > 0 && (utterance.text[end - 1] & 0xC0) == 0x80)
+                    end--;
+                cut = (end > 1 && (utterance.text[end - 1] & 0xC0) == 0xC0) ? end - 1 : utterance.text.size();
+            }
+            ready.push_back(utterance.text.substr(0, cut));
+            utterance.text.erase(0, cut);
+            break;
+        }
+    }
+
+    // The end of the text is told with its last chunks, so that an utterance with
+    // no chunk left is only over once it is
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(!utterance.ended) {
+        for(auto &chunk : ready)
+            utterance.chunks.push_back(std::move(chunk));
+    }
+    utterance.streaming = streaming;
+}
+
+void SessionTable::prefetch(const UtterancePtr &utterance) {
+    m_reader.post([this, utterance] {
+        fill(*utterance);
+
+        // The chunk was wanted before it was read, or the text ran out while no chunk was pending
+        ChunkProgress progress = {utterance, false, false, false, false, {}};
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            progress.wantNext = utterance->started && utterance->outstanding < 2 && !utterance->ended && !m_closed;
+        }
+        if(progress.wantNext)
+            carryOut(utterance->session, SpeechComplete, 0, utterance->data.id, progress);
+    });
+}
+
+void SessionTable::carryOut(const SessionPtr &session, SpeechEvent event, uint32_t serviceid, uint32_t clientSpeechId, ChunkProgress &progress) {
+    if(progress.repoint) {
+        session->speeches.removeClientId(clientSpeechId);
+        session->speeches.add(clientSpeechId, serviceid);
+    }
+
+    for(auto withdrawn : progress.withdrawn)
+        m_canceller(withdrawn);
+
+    // Only the chunks read already are taken, the streamed text is read by prefetch()
+    // which submits the chunk itself when it wasn't ready in time
+    ScheduledList::iterator next = m_inflight.end();
+    bool streaming = false;
+    if(progress.wantNext) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Utterance &utterance = *progress.utterance;
+        if(!utterance.ended) {
+            if(!utterance.chunks.empty() && utterance.outstanding < 2 && !m_closed) {
+                next = queueChunk(progress.utterance);
+                streaming = utterance.streaming;
+            } else if(!utterance.outstanding && !utterance.streaming) {
+                // The text ran out while no chunk was pending
+                utterance.ended = true;
+                utterance.chunks.clear();
+                progress.notify = progress.ended = true;
+            }
+        }
+    }
+
+    if(streaming)
+        prefetch(progress.utterance);
+
+    if(next != m_inflight.end() && submit(next, nullptr) != TTS_OK) {
+        // The rest of the text is lost, the utterance ends with the chunks already submitted
+        TTSLOG_ERROR("Coudn't submit the next chunk of speech with clientid-%d", clientSpeechId);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        progress.utterance->chunks.clear();
+        progress.utterance->streaming = false;
+        if(!--progress.utterance->outstanding && !progress.utterance->ended.exchange(true)) {
+            event = SpeechCancel;
+            progress.notify = progress.ended = true;
+        }
+    }
+
+    if(progress.ended) {
+        session->speeches.removeClientId(clientSpeechId);
+        session->states.remove(clientSpeechId);
+    } else if(event == SpeechPause) {
+        session->states.set(clientSpeechId, SPEECH_PAUSED);
+    } else if(event == SpeechStart || event == SpeechResume) {
+        session->states.set(clientSpeechId, SPEECH_IN_PROGRESS);
+    }
+
+    if(progress.notify)
+        notify(session, event, clientSpeechId);
+}
+
+void SessionTable::notify(const SessionPtr &session, SpeechEvent event, uint32_t clientSpeechId) {
+    deliver(session, event, clientSpeechId);
+
+    // Events after SpeechResume end the speech
+    for(auto follower : session->duplicates.followers(clientSpeechId, event > SpeechResume)) {
+        switch(event) {
+            case SpeechStart: session->states.set(follower, SPEECH_IN_PROGRESS); break;
+            case SpeechPause: session->states.set(follower, SPEECH_PAUSED); break;
+            case SpeechResume: session->states.set(follower, SPEECH_IN_PROGRESS); break;
+            default: session->states.remove(follower); break;
+        }
+        deliver(session, event, follower);
+    }
+}
+
+void SessionTable::deliver(const SessionPtr &session, SpeechEvent event, uint32_t clientSpeechId) {
+    uint32_t required = 0;
+    switch(event) {
+        case SpeechPause: required = EXT_EVENT_PAUSED; break;
+        case SpeechResume: required = EXT_EVENT_RESUMED; break;
+        case SpeechCancel: required = EXT_EVENT_CANCELLED; break;
+        case SpeechInterrupt: required = EXT_EVENT_INTERRUPTED; break;
+        case NetworkError: required = EXT_EVENT_NETWORK_ERROR; break;
+        case PlaybackError: required = EXT_EVENT_PLAYBACK_ERROR; break;
+        default: break;
+    }
+
+    // Start & complete are always delivered, the others only when the app asked for them
+    TTSSessionCallback *callback = session->callback;
+    if(!callback || (required && !(session->eventMask & required)))
+        return;
+
+    uint32_t appId = session->appId;
+    uint32_t sessionId = session->id;
+    switch(event) {
+        case SpeechStart: {
+            SpeechData data(clientSpeechId);
+            TTSLOG_INFO("Got started event from session %u", sessionId);
+            callback->onSpeechStart(appId, sessionId, data);
+            break;
+        }
+        case SpeechPause:
+            TTSLOG_INFO("Got paused event from session %u", sessionId);
+            callback->onSpeechPause(appId, sessionId, clientSpeechId);
+            break;
+        case SpeechResume:
+            TTSLOG_INFO("Got resumed event from session %u", sessionId);
+            callback->onSpeechResume(appId, sessionId, clientSpeechId);
+            break;
+        case SpeechCancel:
+            TTSLOG_INFO("Got cancelled event from session %u, speech id %u", sessionId, clientSpeechId);
+            callback->onSpeechCancelled(appId, sessionId, clientSpeechId);
+            break;
+        case SpeechInterrupt:
+            TTSLOG_INFO("Got interrupted event from session %u", sessionId);
+            callback->onSpeechInterrupted(appId, sessionId, clientSpeechId);
+            break;
+        case NetworkError:
+            TTSLOG_INFO("Got networkerror event from session %u", sessionId);
+            callback->onNetworkError(appId, sessionId, clientSpeechId);
+            break;
+        case PlaybackError:
+            TTSLOG_INFO("Got playbackerror event from session %u", sessionId);
+            callback->onPlaybackError(appId, sessionId, clientSpeechId);
+            break;
+        case SpeechComplete: {
+            SpeechData data(clientSpeechId);
+            TTSLOG_INFO("Got spoke event from session %u", sessionId);
+            callback->onSpeechComplete(appId, sessionId, data);
+            break;
+        }
+        case SpeechExpired:
+            TTSLOG_INFO("Speech %u of session %u expired", clientSpeechId, sessionId);
+            callback->onSpeechExpired(appId, sessionId, clientSpeechId);
+            break;
+    }
+}
+
+void SessionTable::forget(Session *session, uint32_t clientSpeechId, uint32_t serviceid) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // A reused service id may be owned by a newer speech already
+    auto owner = m_speechOwners.find(serviceid);
+    if(owner == m_speechOwners.end() || owner->second->session.get() != session || owner->second->data.id != clientSpeechId)
+        return;
+    m_inflight.erase(owner->second);
+    m_speechOwners.erase(owner);
+}
+
+} // namespace TTS
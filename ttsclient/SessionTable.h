@@ -0,0 +1,293 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef _TTS_SESSION_TABLE_H_
+#define _TTS_SESSION_TABLE_H_
+
+#include "TTSClient.h"
+#include "SpeechIdIndex.h"
+#include "SpeechStateTable.h"
+#include "DuplicateFilter.h"
+#include "DurationPredictor.h"
+#include "Executor.h"
+
+#include <unordered_map>
+#include <functional>
+#include <deque>
+#include <list>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace TTS {
+
+// Sessions hosted by one client, all multiplexed over the client's single service
+// connection. Each session has its own callback, speech ids and event mask, the
+// service speech ids are indexed to their session so that the events are routed
+// without a scan. An app has at most one session.
+//
+// The table also schedules the client's speeches by priority. Normal speeches go
+// straight to the service, high priority (or preemptive session) speeches cancel
+// the lower priority speech in progress and are submitted ahead of the lower priority
+// ones still pending at the service, low priority speeches are held back until none
+// of the client's speeches is pending at the service.
+//
+// Long texts of a chunking session are spoken as an utterance of sentence / clause
+// chunks. The first chunk is submitted as the speech, each next one is submitted when
+// its predecessor starts so that it is queued at the service. The chunks go by the
+// client speech id, the app sees the start of the first, the complete of the last and
+// any other end of a chunk ends the whole utterance. Streamed speeches are utterances
+// whose text is read from their source a chunk ahead of the one being spoken, on the
+// executor's blocking lane so that a slow source never holds the events up.
+//
+// A speak-ahead session keeps only a few of its speeches at the service, the one in
+// progress and "speakAhead" more queued behind it so that they follow without a gap.
+// The others wait in the table, in request order, and move on as the speeches end.
+//
+// Speeches with a deadline are dropped once it passes while they are held or waiting,
+// and cancelled at the service when they haven't started by then. The held and waiting
+// speeches are ordered earliest deadline first within their priority, the deadlines
+// are watched by delayed jobs on the executor's blocking lane, scheduled for the
+// earliest deadline.
+class SessionTable {
+public:
+    enum SpeechEvent {
+        SpeechStart,
+        SpeechPause,
+        SpeechResume,
+        SpeechCancel,
+        SpeechInterrupt,
+        NetworkError,
+        PlaybackError,
+        SpeechComplete,
+        SpeechExpired       // of the client, not the service
+    };
+
+    struct Session {
+        Session(uint32_t sessionId, uint32_t app, const std::string &name, TTSSessionCallback *cb) :
+            id(sessionId), appId(app), appName(name), callback(cb), eventMask(EXT_EVENT_ALL), lastSpeechId(0), preemptive(false), chunked(false), resourcePriority(0), speakAhead(0) {}
+
+        const uint32_t id;
+        const uint32_t appId;
+        const std::string appName;
+        std::atomic<TTSSessionCallback*> callback;
+        std::atomic<uint32_t> eventMask;
+        std::atomic<uint32_t> lastSpeechId;
+        std::atomic<bool> preemptive;
+        std::atomic<bool> chunked;
+        std::atomic<uint32_t> resourcePriority;
+        std::atomic<uint32_t> speakAhead;
+        SpeechIdIndex speeches;
+        SpeechStateTable states;
+        DuplicateFilter duplicates;
+    };
+    using SessionPtr = std::shared_ptr<Session>;
+
+    // A speech accepted by the service, serviceid 0 when the service didn't return one
+    struct Submission {
+        SpeechData data;
+        uint32_t serviceid;
+    };
+
+    // Backend calls used to (re)submit and withdraw the speeches, never called under the table lock
+    using Submitter = std::function<TTS_Error (SpeechData &data, uint32_t &serviceid)>;
+    using Canceller = std::function<bool (uint32_t serviceid)>;
+
+    SessionTable(Submitter submitter, Canceller canceller);
+    ~SessionTable();
+
+    // Creating a session for an app that has one already replaces its callback
+    SessionPtr create(uint32_t appId, const std::string &appName, TTSSessionCallback *callback);
+    bool destroy(uint32_t sessionId);
+
+    SessionPtr find(uint32_t sessionId);
+    SessionPtr findForApp(uint32_t appId);
+    std::vector<SessionPtr> sessions();
+    // Union of the extended events the sessions asked for, none once closed
+    uint32_t eventInterest();
+
+    // Submits the speech or holds it back as per its priority, "serviceSpeechId" is 0
+    // for a held speech. A merged duplicate gets the service id of its original
+    TTS_Error speak(const SessionPtr &session, SpeechData &data, uint32_t *serviceSpeechId);
+    // Speaks the text of "source", the text of "data" is ignored
+    TTS_Error speakStream(const SessionPtr &session, SpeechData &data, TextSource &source);
+
+    // 0 turns speaking ahead off, the waiting speeches are scheduled right away
+    void setSpeakAhead(const SessionPtr &session, uint32_t depth);
+    // Rate of the configuration, for the duration predictions
+    void setSpeechRate(uint8_t rate);
+    // Predicted start & duration of the session's speeches, in the order they are spoken
+    std::vector<SpeechEstimate> estimates(const SessionPtr &session);
+
+    // Batches bypass the scheduler, only normal priority speeches without a deadline which
+    // would have been submitted straight away can be batched
+    bool canBatch(const SessionPtr &session, const std::vector<SpeechData> &data);
+
+    // Schedules the speeches one by one, for the batches which can't bypass the scheduler
+    TTS_Error speakEach(const SessionPtr &session, std::vector<SpeechData> &data, std::vector<TTS_Error> &results);
+
+    // Records the speeches submitted in a batch, returns the number of new client ids
+    size_t addSpeeches(const SessionPtr &session, const std::vector<Submission> &speeches);
+
+    // Drops the speeches of the session held back by the scheduler, those are cancelled
+    void clearHeld(const SessionPtr &session);
+
+    // Cancels the session's speech pending at the service, unless it started or is
+    // a chunk of an utterance. Returns false when it wasn't withdrawn
+    bool withdraw(const SessionPtr &session, uint32_t serviceid);
+
+    // The service ids of the app's speeches pending at the service, the caller cancels
+    // them through canceller() once it doesn't hold any lock. A speech being submitted
+    // meanwhile is cancelled by submit() if the app no longer holds the resource
+    std::vector<uint32_t> submittedSpeeches(uint32_t appId);
+    const Canceller &canceller() const { return m_canceller; }
+
+    // The service dropped all the speeches, held speeches are cancelled
+    void reset();
+
+    // No speech is submitted from now on, called before the backend goes away
+    void close();
+
+    // Updates the owning session's speech state and notifies its app,
+    // the speeches of the other clients are ignored
+    void dispatch(SpeechEvent event, uint32_t serviceid);
+
+private:
+    // Guarded by m_mutex, "ended" is also tested without it. The source is read under
+    // readMutex alone, so that a slow source doesn't hold the table up
+    struct Utterance {
+        Utterance(const SessionPtr &s, const SpeechData &d, SpeechPriority p) :
+            session(s), data(d), priority(p), outstanding(0), started(false), ended(false), source(nullptr), streaming(false) {
+            data.text.clear();
+        }
+
+        const SessionPtr session;
+        SpeechData data;                  // id & options of the chunks
+        const SpeechPriority priority;
+        std::deque<std::string> chunks;   // not submitted yet
+        uint32_t outstanding;             // chunks submitted (or being submitted) and not ended
+        bool started;
+        std::atomic<bool> ended;
+
+        TextSource *source;
+        std::string text;                 // read from the source, not cut into chunks yet
+        std::atomic<bool> streaming;      // the source has more text, cleared with the last chunks
+        std::mutex readMutex;
+    };
+    using UtterancePtr = std::shared_ptr<Utterance>;
+
+    struct Scheduled {
+        SessionPtr session;
+        SpeechData data;
+        SpeechPriority priority;
+        uint32_t serviceid;
+        UtterancePtr utterance;
+    };
+    using ScheduledList = std::list<Scheduled>;
+
+    // What an event of a chunk leads to, carried out once the lock is released
+    struct ChunkProgress {
+        UtterancePtr utterance;
+        bool notify;                        // the event is the utterance's own
+        bool repoint;                       // the client speech id moves to this chunk
+        bool ended;
+        bool wantNext;                      // the next chunk is to be submitted
+        std::vector<uint32_t> withdrawn;    // the utterance's other chunks at the service
+    };
+
+    SessionTable(const SessionTable&) = delete;
+    SessionTable& operator=(const SessionTable&) = delete;
+
+    SpeechPriority priorityOf(const SessionPtr &session, const SpeechData &data);
+    TTS_Error schedule(Scheduled &&scheduled, uint32_t *serviceSpeechId);
+    void hold(Scheduled &&speech);
+    // Returns true when the speech waits for its turn to be scheduled, "speech" is
+    // left alone otherwise
+    bool queueAhead(Scheduled &speech);
+    // Schedules the waiting speeches of the session which are due
+    void promote(const SessionPtr &session);
+    // Expect m_mutex to be held
+    size_t scheduledCount(const SessionPtr &session);
+    bool isExpired(const Scheduled &speech, std::chrono::steady_clock::time_point now);
+    // Ahead of the speeches with a later deadline or none
+    bool isMoreUrgent(const Scheduled &speech, const Scheduled &than);
+    // Checks the deadlines right away, for a new speech with a deadline
+    void watchDeadlines();
+    // Expects m_mutex to be held, checks the deadlines at "due" unless a check is due before
+    void scheduleCheck(std::chrono::steady_clock::time_point due);
+    // Drops & cancels the expired speeches, runs on m_watcher
+    void checkDeadlines();
+    // Follows the speech in progress, learning the pace from the speeches spoken through
+    void track(SpeechEvent event, uint32_t serviceid, size_t length);
+    bool takeUnowned(uint32_t serviceid);
+    TTS_Error submit(ScheduledList::iterator speech, uint32_t *serviceSpeechId);
+    void pump();
+    void runPump();
+    void drop(ScheduledList &speeches, SpeechEvent event = SpeechCancel);
+    // Also notifies the repeats merged into the speech
+    void notify(const SessionPtr &session, SpeechEvent event, uint32_t clientSpeechId);
+    void deliver(const SessionPtr &session, SpeechEvent event, uint32_t clientSpeechId);
+    // Returns true when the speech was dropped or merged, "error" is the speak result
+    bool suppressDuplicate(const SessionPtr &session, SpeechData &data, uint32_t *serviceSpeechId, TTS_Error &error);
+    // Drops the speech the index evicted, unless its service id is owned by another one
+    void forget(Session *session, uint32_t clientSpeechId, uint32_t serviceid);
+    // Expect m_mutex to be held
+    ChunkProgress advance(ScheduledList::iterator chunk, SpeechEvent event);
+    ScheduledList::iterator queueChunk(const UtterancePtr &utterance);
+    // Reads the source until a chunk is ready or the text is over
+    void fill(Utterance &utterance);
+    // Fills the utterance on m_reader, and submits the chunk if it was wanted meanwhile
+    void prefetch(const UtterancePtr &utterance);
+    void carryOut(const SessionPtr &session, SpeechEvent event, uint32_t serviceid, uint32_t clientSpeechId, ChunkProgress &progress);
+
+    Submitter m_submitter;
+    Canceller m_canceller;
+    std::unordered_map<uint32_t, SessionPtr> m_sessions;
+    std::unordered_map<uint32_t, uint32_t> m_appSessions;
+    // Speeches pending at the service in submission order, m_playing is the one in progress
+    ScheduledList m_inflight;
+    std::unordered_map<uint32_t, ScheduledList::iterator> m_speechOwners;
+    // Speeches held back, highest priority first
+    ScheduledList m_held;
+    // Speeches of the speak-ahead sessions waiting for their turn, in request order
+    ScheduledList m_queued;
+    DurationPredictor m_predictor;
+    // The speech in progress, as far as this client knows
+    uint32_t m_playing;
+    std::chrono::steady_clock::time_point m_playingSince;
+    size_t m_playingLength;
+    bool m_playingPaused;
+    std::deque<uint32_t> m_unowned;
+    uint32_t m_nextSessionId;
+    // High priority speeches being submitted ahead of the ones they withdrew
+    uint32_t m_preempting;
+    bool m_pumping;
+    bool m_closed;
+    std::chrono::steady_clock::time_point m_nextCheck;
+    std::mutex m_mutex;
+    Executor::Strand m_watcher;
+    // Reads the streamed texts
+    Executor::Strand m_reader;
+};
+
+} // namespace TTS
+
+#endif //_TTS_SESSION_TABLE_H_
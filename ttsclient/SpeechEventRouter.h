@@ -0,0 +1,102 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef _TTS_SPEECH_EVENT_ROUTER_H_
+#define _TTS_SPEECH_EVENT_ROUTER_H_
+
+#include <unordered_map>
+#include <iterator>
+#include <mutex>
+#include <list>
+
+namespace TTS {
+
+// Owner of every speech requested through a service, so that the per-speech events
+// are delivered to that client alone instead of being broadcast to all the clients.
+// Speeches whose owner is unknown (not registered yet, or the oldest ones dropped once
+// the bound is hit) fall back to the broadcast, where the clients filter by their own
+// speech ids.
+template<typename ClientType>
+class SpeechEventRouter {
+public:
+    SpeechEventRouter(size_t capacity = 4096) : m_capacity(capacity ? capacity : 1) {}
+
+    void add(uint32_t speechid, ClientType *client) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_owners.find(speechid);
+        if(it != m_owners.end()) {
+            erase(it);
+        } else if(m_owners.size() >= m_capacity) {
+            // Speeches are kept in registration order, the oldest one is at the front
+            erase(m_owners.find(m_order.front()));
+        }
+
+        m_order.push_back(speechid);
+        m_owners.emplace(speechid, Owner { client, std::prev(m_order.end()) });
+    }
+
+    // The speech is forgotten with its terminal event
+    ClientType *owner(uint32_t speechid, bool terminal) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_owners.find(speechid);
+        if(it == m_owners.end())
+            return nullptr;
+
+        ClientType *client = it->second.client;
+        if(terminal)
+            erase(it);
+        return client;
+    }
+
+    void remove(ClientType *client) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for(auto it = m_owners.begin(); it != m_owners.end();) {
+            auto next = std::next(it);
+            if(it->second.client == client)
+                erase(it);
+            it = next;
+        }
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_owners.clear();
+        m_order.clear();
+    }
+
+private:
+    struct Owner {
+        ClientType *client;
+        std::list<uint32_t>::iterator position;
+    };
+    using OwnerMap = std::unordered_map<uint32_t, Owner>;
+
+    void erase(typename OwnerMap::iterator it) {
+        m_order.erase(it->second.position);
+        m_owners.erase(it);
+    }
+
+    const size_t m_capacity;
+    OwnerMap m_owners;
+    std::list<uint32_t> m_order;
+    std::mutex m_mutex;
+};
+
+} // namespace TTS
+
+#endif //_TTS_SPEECH_EVENT_ROUTER_H_
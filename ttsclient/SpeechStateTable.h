@@ -0,0 +1,187 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef _TTS_SPEECH_STATE_TABLE_H_
+#define _TTS_SPEECH_STATE_TABLE_H_
+
+#include "TTSCommon.h"
+
+#include <unordered_map>
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+namespace TTS {
+
+// State of the speeches requested by this client, driven by the service's speech
+// events so that the state queries are answered without an IPC. Events may have
+// been missed across a connection loss, the table is untrusted from then on until
+// a wire query re-syncs it.
+//
+// The last "capacity" speeches that ended before they were registered are remembered
+// for "endedMaxAge", so that their late registration doesn't leave them pending.
+// Speeches pending for longer than "pendingMaxAge" (i.e. whose end was never seen)
+// are dropped on the next registration.
+class SpeechStateTable {
+public:
+    SpeechStateTable(size_t capacity = 16,
+                     std::chrono::seconds endedMaxAge = std::chrono::seconds(10),
+                     std::chrono::seconds pendingMaxAge = std::chrono::seconds(30 * 60)) :
+        m_capacity(capacity ? capacity : 1),
+        m_endedMaxAge(endedMaxAge),
+        m_pendingMaxAge(pendingMaxAge),
+        m_speaking(0),
+        m_trusted(true) {
+    }
+
+    // Registers a new request, an event that raced ahead of it takes precedence
+    void add(uint32_t speechId) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = Clock::now();
+        if(takeEnded(speechId, now))
+            return;
+
+        for(auto it = m_states.begin(); it != m_states.end();) {
+            if(it->second.state == SPEECH_PENDING && now - it->second.since > m_pendingMaxAge)
+                it = m_states.erase(it);
+            else
+                ++it;
+        }
+        m_states.emplace(speechId, Entry { SPEECH_PENDING, now });
+    }
+
+    // SPEECH_NOT_FOUND removes the speech
+    void set(uint32_t speechId, SpeechState state) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = Clock::now();
+        auto it = m_states.find(speechId);
+        if(it != m_states.end()) {
+            if(it->second.state == SPEECH_IN_PROGRESS)
+                --m_speaking;
+            if(state == SPEECH_NOT_FOUND) {
+                m_states.erase(it);
+                return;
+            }
+            it->second = { state, now };
+        } else if(state != SPEECH_NOT_FOUND) {
+            m_states.emplace(speechId, Entry { state, now });
+        } else {
+            // Ended before it was registered
+            if(m_trusted) {
+                m_ended.push_back({ speechId, now });
+                if(m_ended.size() > m_capacity)
+                    m_ended.pop_front();
+            }
+            return;
+        }
+
+        if(state == SPEECH_IN_PROGRESS)
+            ++m_speaking;
+    }
+
+    void remove(uint32_t speechId) {
+        set(speechId, SPEECH_NOT_FOUND);
+    }
+
+    // Moves a known speech from "from" to "to" only, for the requests whose
+    // events may not be subscribed (pause & resume)
+    void update(uint32_t speechId, SpeechState from, SpeechState to) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_states.find(speechId);
+        if(it == m_states.end() || it->second.state != from)
+            return;
+
+        if(from == SPEECH_IN_PROGRESS)
+            --m_speaking;
+        if(to == SPEECH_IN_PROGRESS)
+            ++m_speaking;
+        it->second.state = to;
+    }
+
+    // Returns false when the table can't answer, i.e. the speech is unknown
+    // and the table is not trusted
+    bool get(uint32_t speechId, SpeechState &state) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_states.find(speechId);
+        state = (it != m_states.end()) ? it->second.state : SPEECH_NOT_FOUND;
+        return m_trusted || it != m_states.end();
+    }
+
+    bool isSpeaking(bool &speaking) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        speaking = (m_speaking > 0);
+        return m_trusted || speaking;
+    }
+
+    bool hasPending() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return !m_states.empty();
+    }
+
+    void invalidate() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_states.clear();
+        m_ended.clear();
+        m_speaking = 0;
+        m_trusted = false;
+    }
+
+    void resync() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_trusted = true;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        SpeechState state;
+        Clock::time_point since;
+    };
+
+    struct Ended {
+        uint32_t speechId;
+        Clock::time_point at;
+    };
+
+    bool takeEnded(uint32_t speechId, Clock::time_point now) {
+        while(!m_ended.empty() && now - m_ended.front().at > m_endedMaxAge)
+            m_ended.pop_front();
+
+        for(auto it = m_ended.begin(); it != m_ended.end(); ++it) {
+            if(it->speechId == speechId) {
+                m_ended.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const size_t m_capacity;
+    const std::chrono::seconds m_endedMaxAge;
+    const std::chrono::seconds m_pendingMaxAge;
+    std::unordered_map<uint32_t, Entry> m_states;
+    std::deque<Ended> m_ended;
+    uint32_t m_speaking;
+    bool m_trusted;
+    std::mutex m_mutex;
+};
+
+} // namespace TTS
+
+#endif //_TTS_SPEECH_STATE_TABLE_H_
@@ -17,6 +17,8 @@
  * limitations under the License.
 */
 
+#include "AsyncSpeechQueue.h"
+#include "ResourceArbiter.h"
 #include "TTSClientPrivateCOMRPC.h"
 #include "TTSClientPrivateJsonRPC.h"
 #ifdef TTS_DEFAULT_BACKEND_FIREBOLT
@@ -81,7 +83,9 @@ TTSClient *TTSClient::create(TTSConnectionCallback *callback, bool discardRtDisp
     return new TTSClient(backend, callback, discardRtDispatching);
 }
 
-TTSClient::TTSClient(Backend backend, TTSConnectionCallback *callback, bool discardRtDispatching) {
+TTSClient::TTSClient(Backend backend, TTSConnectionCallback *callback, bool discardRtDispatching) :
+    m_priv(NULL),
+    m_asyncQueue(NULL) {
     switch(backend) {
         case COM:
             TTSLOG_INFO("TTSClient is using COMRPC");
@@ -99,9 +103,17 @@ TTSClient::TTSClient(Backend backend, TTSConnectionCallback *callback, bool disc
 	    break;
 #endif
     }
+
+    if(m_priv)
+        m_asyncQueue = new AsyncSpeechQueue(m_priv);
 }
 
 TTSClient::~TTSClient() {
+    if(m_asyncQueue) {
+        delete m_asyncQueue;
+        m_asyncQueue = NULL;
+    }
+
     if(m_priv) {
         delete m_priv;
         m_priv = NULL;
@@ -124,8 +136,12 @@ TTS_Error TTSClient::setTTSConfiguration(Configuration &config) {
 }
 
 TTS_Error TTSClient::getTTSConfiguration(Configuration &config) {
+    return getTTSConfiguration(config, false);
+}
+
+TTS_Error TTSClient::getTTSConfiguration(Configuration &config, bool forcefetch) {
     CHECK_PRIV();
-    return m_priv->getTTSConfiguration(config);
+    return m_priv->getTTSConfiguration(config, forcefetch);
 }
 
 bool TTSClient::isTTSEnabled(bool forcefetch) {
@@ -153,6 +169,16 @@ TTS_Error TTSClient::releaseResource(uint32_t appid) {
     return m_priv->releaseResource(appid);
 }
 
+TTS_Error TTSClient::setResourcePriority(uint32_t sessionid, uint32_t priority) {
+    CHECK_PRIV();
+    return m_priv->setResourcePriority(sessionid, priority);
+}
+
+TTS_Error TTSClient::getResourceStats(ResourceStats &stats) {
+    stats = ResourceArbiter::Instance().stats();
+    return TTS_OK;
+}
+
 uint32_t TTSClient::createSession(uint32_t sessionid, std::string appname, TTSSessionCallback *callback) {
     CHECK_PRIV();
     return m_priv->createSession(sessionid, appname, callback);
@@ -160,6 +186,8 @@ uint32_t TTSClient::createSession(uint32_t sessionid, std::string appname, TTSSe
 
 TTS_Error TTSClient::destroySession(uint32_t sessionid) {
     CHECK_PRIV();
+    m_asyncQueue->clear(sessionid);
+    m_asyncQueue->forget(sessionid);
     return m_priv->destroySession(sessionid);
 }
 
@@ -173,6 +201,31 @@ TTS_Error TTSClient::setPreemptiveSpeak(uint32_t sessionid, bool preemptive) {
     return m_priv->setPreemptiveSpeak(sessionid, preemptive);
 }
 
+TTS_Error TTSClient::setSpeechChunking(uint32_t sessionid, bool enable) {
+    CHECK_PRIV();
+    return m_priv->setSpeechChunking(sessionid, enable);
+}
+
+TTS_Error TTSClient::setDuplicateSuppression(uint32_t sessionid, DuplicateSpeechPolicy policy, uint32_t windowMs) {
+    CHECK_PRIV();
+    return m_priv->setDuplicateSuppression(sessionid, policy, windowMs);
+}
+
+TTS_Error TTSClient::getDuplicateStats(uint32_t sessionid, DuplicateStats &stats) {
+    CHECK_PRIV();
+    return m_priv->getDuplicateStats(sessionid, stats);
+}
+
+TTS_Error TTSClient::setSpeakAhead(uint32_t sessionid, uint32_t depth) {
+    CHECK_PRIV();
+    return m_priv->setSpeakAhead(sessionid, depth);
+}
+
+TTS_Error TTSClient::getSpeechEstimates(uint32_t sessionid, std::vector<SpeechEstimate> &estimates) {
+    CHECK_PRIV();
+    return m_priv->getSpeechEstimates(sessionid, estimates);
+}
+
 TTS_Error TTSClient::requestExtendedEvents(uint32_t sessionid, uint32_t extendedEvents) {
     CHECK_PRIV();
     return m_priv->requestExtendedEvents(sessionid, extendedEvents);
@@ -183,6 +236,34 @@ TTS_Error TTSClient::speak(uint32_t sessionid, SpeechData& data) {
     return m_priv->speak(sessionid, data);
 }
 
+TTS_Error TTSClient::speakAsync(uint32_t sessionid, SpeechData&& data, SpeakCompletion completion) {
+    CHECK_PRIV();
+    m_asyncQueue->post(sessionid, std::move(data), std::move(completion));
+    return TTS_OK;
+}
+
+TTS_Error TTSClient::speakOnChannel(uint32_t sessionid, const std::string &channel, SpeechData&& data, SpeakCompletion completion) {
+    CHECK_PRIV();
+    m_asyncQueue->post(sessionid, channel, std::move(data), std::move(completion));
+    return TTS_OK;
+}
+
+TTS_Error TTSClient::setChannelQuietPeriod(uint32_t sessionid, const std::string &channel, uint32_t quietMs) {
+    CHECK_PRIV();
+    m_asyncQueue->setQuietPeriod(sessionid, channel, std::chrono::milliseconds(quietMs));
+    return TTS_OK;
+}
+
+TTS_Error TTSClient::speakBatch(uint32_t sessionid, std::vector<SpeechData>& data, std::vector<TTS_Error> &results) {
+    CHECK_PRIV();
+    return m_priv->speakBatch(sessionid, data, results);
+}
+
+TTS_Error TTSClient::speakStream(uint32_t sessionid, SpeechData& data, TextSource &source) {
+    CHECK_PRIV();
+    return m_priv->speakStream(sessionid, data, source);
+}
+
 TTS_Error TTSClient::pause(uint32_t sessionid, uint32_t speechid) {
     CHECK_PRIV();
     return m_priv->pause(sessionid, speechid);
@@ -195,17 +276,27 @@ TTS_Error TTSClient::resume(uint32_t sessionid, uint32_t speechid) {
 
 TTS_Error TTSClient::abort(uint32_t sessionid, bool clearPending) {
     CHECK_PRIV();
+    if(clearPending)
+        m_asyncQueue->clear(sessionid);
     return m_priv->abort(sessionid, clearPending);
 }
 
 bool TTSClient::isSpeaking(uint32_t sessionid) {
+    return isSpeaking(sessionid, false);
+}
+
+bool TTSClient::isSpeaking(uint32_t sessionid, bool forcefetch) {
     CHECK_PRIV();
-    return m_priv->isSpeaking(sessionid);
+    return m_priv->isSpeaking(sessionid, forcefetch);
 }
 
 TTS_Error TTSClient::getSpeechState(uint32_t sessionid, uint32_t speechid, SpeechState &state) {
+    return getSpeechState(sessionid, speechid, state, false);
+}
+
+TTS_Error TTSClient::getSpeechState(uint32_t sessionid, uint32_t speechid, SpeechState &state, bool forcefetch) {
     CHECK_PRIV();
-    return m_priv->getSpeechState(sessionid, speechid, state);
+    return m_priv->getSpeechState(sessionid, speechid, state, forcefetch);
 }
 
 } // namespace TTS
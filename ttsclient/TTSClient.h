@@ -20,8 +20,11 @@
 #define _TTS_CLIENT_H_
 
 #include "TTSCommon.h"
+#include "TextSource.h"
 
 #include <iostream>
+#include <functional>
+#include <chrono>
 #include <vector>
 
 namespace TTS {
@@ -41,15 +44,65 @@ struct Configuration {
 };
 
 struct SpeechData {
-    SpeechData() : secure(true), id(0) {}
-    SpeechData(uint32_t i) : secure(true), id(i) {}
+    SpeechData() : secure(true), id(0), priority(SPEECH_PRIORITY_NORMAL) {}
+    SpeechData(uint32_t i) : secure(true), id(i), priority(SPEECH_PRIORITY_NORMAL) {}
     ~SpeechData() {}
 
+    // The speech is dropped (onSpeechExpired) unless it starts within "ttl"
+    void expireIn(std::chrono::milliseconds ttl) { deadline = std::chrono::steady_clock::now() + ttl; }
+    bool hasDeadline() const { return deadline != std::chrono::steady_clock::time_point(); }
+
     bool secure;
     uint32_t id;
     std::string text;
+    SpeechPriority priority;
+    // Latest start of the speech, none by default
+    std::chrono::steady_clock::time_point deadline;
+};
+
+// Resource arbitration counters of the process, the latency is taken from the
+// acquire / claim request to the grant of the resource
+struct ResourceStats {
+    ResourceStats() : granted(0), preempted(0), queued(0), rejected(0), totalLatencyUs(0), maxLatencyUs(0) {}
+
+    uint64_t granted;
+    uint64_t preempted;
+    uint64_t queued;
+    uint64_t rejected;
+    uint64_t totalLatencyUs;
+    uint64_t maxLatencyUs;
 };
 
+// What becomes of a speech whose text the session has pending or in progress already
+enum DuplicateSpeechPolicy {
+    DUPLICATE_SPEAK = 0,    // spoken again (default)
+    DUPLICATE_DROP,         // not spoken, speak() returns TTS_SPEECH_DUPLICATE
+    DUPLICATE_MERGE         // not spoken, its id gets the events of the speech it repeats
+};
+
+// Duplicate suppression counters of a session. "outsideWindow" counts the repeats
+// spoken only because the speech they repeat was requested before the window
+struct DuplicateStats {
+    DuplicateStats() : checked(0), dropped(0), merged(0), outsideWindow(0) {}
+
+    uint64_t checked;
+    uint64_t dropped;
+    uint64_t merged;
+    uint64_t outsideWindow;
+};
+
+// Predicted schedule of a speech, from this client's view (the speeches of the other
+// clients at the service are not known)
+struct SpeechEstimate {
+    uint32_t speechId;
+    uint32_t startsInMs;    // 0 for the speech in progress
+    uint32_t durationMs;    // left to speak for the speech in progress
+};
+
+// Completion of a speakAsync() request, invoked on the library's submission thread.
+// "serviceSpeechId" is the id assigned by the TTS service (0 when the request failed).
+using SpeakCompletion = std::function<void (TTS_Error error, uint32_t speechId, uint32_t serviceSpeechId)>;
+
 class TTSConnectionCallback {
 public:
     TTSConnectionCallback() {}
@@ -78,15 +131,19 @@ public:
     virtual void onNetworkError(uint32_t appId, uint32_t sessionId, uint32_t speechId) { (void)appId; (void)sessionId; (void)speechId; }
     virtual void onPlaybackError(uint32_t appId, uint32_t sessionId, uint32_t speechId) { (void)appId; (void)sessionId; (void)speechId; }
     virtual void onSpeechComplete(uint32_t appId, uint32_t sessionId, SpeechData &data) { (void)appId; (void)sessionId; (void)data; }
+    // The speech didn't start before its deadline, it was dropped or cancelled at the service
+    virtual void onSpeechExpired(uint32_t appId, uint32_t sessionId, uint32_t speechId) { (void)appId; (void)sessionId; (void)speechId; }
 };
 
 //
 // Note :
-// The Session APIs are designed to have multiple sessions for a client
-// But at present the implementation supports single session. So the sessionid input for
-// all the APIs, except createSession, will be omitted, the internaly maintained ID will be used.
+// A client can host multiple sessions over its single service connection, one per app.
+// Each session has its own callback, speech ids and extended event mask. Creating a session
+// for an app that already has one returns the existing id with the new callback.
+// APIs called with an unknown sessionid fail.
 //
 class TTSClientPrivateInterface;
+class AsyncSpeechQueue;
 class TTSClient {
 public:
     enum Backend {
@@ -105,34 +162,86 @@ public:
     TTS_Error listVoices(std::string language, std::vector<std::string> &voices);
     TTS_Error setTTSConfiguration(Configuration &config);
     TTS_Error getTTSConfiguration(Configuration &config);
+    // Served from the client's copy unless "forcefetch" is set
+    TTS_Error getTTSConfiguration(Configuration &config, bool forcefetch);
     bool isTTSEnabled(bool forcefetch=false);
     bool isSessionActiveForApp(uint32_t appid);
 
-    // Resource management APIs
+    // Resource management APIs, in effect with TTS_CLIENT_RESOURCE_POLICY=reservation|priority.
+    // Only the app holding the resource can speak, the others get TTS_RESOURCE_BUSY.
+    // With the priority policy a busy acquireResource is queued, onResourceAcquired
+    // fires once the resource is handed over
     TTS_Error acquireResource(uint32_t appid);
     TTS_Error claimResource(uint32_t appid);
     TTS_Error releaseResource(uint32_t appid);
+    // Priority of the session's app for the priority policy, higher wins (default 0)
+    TTS_Error setResourcePriority(uint32_t sessionid, uint32_t priority);
+    TTS_Error getResourceStats(ResourceStats &stats);
 
     // Session management APIs
     uint32_t /*sessionid*/ createSession(uint32_t appid, std::string appname, TTSSessionCallback *sessCallback);
     TTS_Error destroySession(uint32_t sessionid);
     bool isActiveSession(uint32_t sessionid, bool forcefetch=false);
+    // Speeches of a preemptive session are spoken with SPEECH_PRIORITY_HIGH
     TTS_Error setPreemptiveSpeak(uint32_t sessionid, bool preemptive);
+    // Long texts of a chunking session are split at sentence / clause boundaries and
+    // spoken chunk by chunk, so that the first words are heard sooner. The app still
+    // sees one speech (one start, one complete) under its own id
+    TTS_Error setSpeechChunking(uint32_t sessionid, bool enable);
+    // Repeats of a speech requested within "windowMs" (0 for no limit) of it while
+    // it is still pending or in progress are dropped or merged as per "policy". A merged
+    // repeat follows the events of its original from then on, pause / resume go by the
+    // original's id. Sessions suppressing duplicates don't batch
+    TTS_Error setDuplicateSuppression(uint32_t sessionid, DuplicateSpeechPolicy policy, uint32_t windowMs = 500);
+    TTS_Error getDuplicateStats(uint32_t sessionid, DuplicateStats &stats);
+    // Keeps the session's speech in progress and "depth" more at the service, the others
+    // wait in the client and are submitted as the speeches end (0, the default, submits
+    // every speech right away)
+    TTS_Error setSpeakAhead(uint32_t sessionid, uint32_t depth);
+    // Predicted from the text lengths & the rate, and learnt from the speeches spoken so far
+    TTS_Error getSpeechEstimates(uint32_t sessionid, std::vector<SpeechEstimate> &estimates);
+    // ExtendedEvents mask, all by default. Pause & resume are subscribed from the service
+    // only while some session wants them
     TTS_Error requestExtendedEvents(uint32_t sessionid, uint32_t extendedEvents);
 
     // Speak APIs
+    // A speech with a deadline is dropped if the deadline passes while it waits in the
+    // client, and cancelled if it is pending at the service and hasn't started by then.
+    // It fails with TTS_SPEECH_EXPIRED when it is already late. The speeches waiting in
+    // the client go earliest deadline first within their priority
     TTS_Error speak(uint32_t sessionid, SpeechData& data);
+    // Queues the request and returns immediately, the completion is invoked
+    // once the service accepted / rejected the request
+    TTS_Error speakAsync(uint32_t sessionid, SpeechData&& data, SpeakCompletion completion = nullptr);
+    // speakAsync on a named channel (e.g. "focus"), latest wins: the request replaces the
+    // channel's request not yet submitted, which completes with TTS_SPEECH_REPLACED. The
+    // last request is submitted once the channel has been quiet for its quiet period
+    TTS_Error speakOnChannel(uint32_t sessionid, const std::string &channel, SpeechData&& data, SpeakCompletion completion = nullptr);
+    // 150ms by default, 0 submits the latest request as soon as the queue gets to it
+    TTS_Error setChannelQuietPeriod(uint32_t sessionid, const std::string &channel, uint32_t quietMs);
+    // Submits all the speeches back to back without waiting on the individual replies,
+    // "results" holds the outcome of each item in the order of "data"
+    TTS_Error speakBatch(uint32_t sessionid, std::vector<SpeechData>& data, std::vector<TTS_Error> &results);
+    // Speaks a long text read from "source" a few sentences ahead of the playback, so
+    // the memory used doesn't depend on the length of the text. "data" carries the id
+    // and options, its text is ignored. The source must stay valid until the end of
+    // the speech is notified, it is not read anymore once the speech is cancelled.
+    TTS_Error speakStream(uint32_t sessionid, SpeechData& data, TextSource &source);
     TTS_Error pause(uint32_t sessionid, uint32_t speechid);
     TTS_Error resume(uint32_t sessionid, uint32_t speechid);
     TTS_Error abort(uint32_t sessionid, bool clearPending = false);
     bool isSpeaking(uint32_t sessionid);
     TTS_Error getSpeechState(uint32_t sessionid, uint32_t speechid, SpeechState &state);
+    // Answered from the client's speech state table unless "forcefetch" is set
+    bool isSpeaking(uint32_t sessionid, bool forcefetch);
+    TTS_Error getSpeechState(uint32_t sessionid, uint32_t speechid, SpeechState &state, bool forcefetch);
 
 private:
     TTSClient(Backend backend, TTSConnectionCallback *client, bool discardRtDispatching=false);
     TTSClient(TTSClient&) = delete;
 
     TTSClientPrivateInterface *m_priv;
+    AsyncSpeechQueue *m_asyncQueue;
 };
 
 } // namespace TTS
@@ -40,17 +40,22 @@ namespace TTS {
 
 #define UNUSED(x) (void)(x)
 
-#define DEFAULT_SESSION_ID 1
+#define GET_SESSION_RETURN_ON_FAIL(session, sessionId, ret) \
+    SessionTable::SessionPtr session = m_sessions.find(sessionId); \
+    if(!session) { \
+        TTSLOG_ERROR("Session %u not found", sessionId); \
+        return ret; \
+    }
 
 // --- //
 
 TTSClientPrivateCOMRPC::TTSClientPrivateCOMRPC(TTSConnectionCallback *callback, bool) :
     m_ttsEnabled(false),
     m_connectionCallback(callback),
-    m_sessionCallback(nullptr),
-    m_lastSpeechId(0),
-    m_appId(0),
-    m_firstQuery(true) {
+    m_firstQuery(true),
+    m_voiceCatalogue([this](std::string &language, std::vector<std::string> &voices) { return fetchVoices(language, voices) == TTS_OK; }),
+    m_sessions([this](SpeechData &data, uint32_t &speechid) { return submit(data, speechid); },
+        [this](uint32_t speechid) { return cancel(speechid); }) {
     if (Core::SystemInfo::GetEnvironment(_T("CLIENT_IDENTIFIER"), m_callsign) == true) {
         std::string::size_type pos =  m_callsign.find(',');
         if (pos != std::string::npos)
@@ -64,12 +69,22 @@ TTSClientPrivateCOMRPC::TTSClientPrivateCOMRPC(TTSConnectionCallback *callback,
 
     if(TextToSpeechServiceCOMRPC::Instance()->isActive() && m_connectionCallback)
         m_connectionCallback->onTTSServerConnected();
+
+    // Fill the configuration cache & voice catalogue up front, the reads are served locally from then on
+    if(TextToSpeechServiceCOMRPC::Instance()->isActive()) {
+        Configuration config;
+        if(getTTSConfiguration(config, true) == TTS_OK)
+            m_voiceCatalogue.prefetch({ config.language });
+    }
 }
 
 TTSClientPrivateCOMRPC::~TTSClientPrivateCOMRPC() {
     TextToSpeechServiceCOMRPC::Instance()->unregisterClient(this);
-    abort(DEFAULT_SESSION_ID, false);
-    destroySession(DEFAULT_SESSION_ID);
+    m_sessions.close();
+    for(auto &session : m_sessions.sessions()) {
+        abort(session->id, false);
+        destroySession(session->id);
+    }
 }
 
 TTS_Error TTSClientPrivateCOMRPC::enableTTS(bool enable) {
@@ -81,6 +96,10 @@ TTS_Error TTSClientPrivateCOMRPC::enableTTS(bool enable) {
 }
 
 TTS_Error TTSClientPrivateCOMRPC::listVoices(std::string &language, std::vector<std::string> &voices) {
+    return m_voiceCatalogue.lookup(language, voices) ? TTS_OK : TTS_FAIL;
+}
+
+TTS_Error TTSClientPrivateCOMRPC::fetchVoices(std::string &language, std::vector<std::string> &voices) {
     if(!TextToSpeechServiceCOMRPC::Instance()->listVoices(language,voices)) {
         TTSLOG_ERROR("Couldn't retrieve voice list");
         return TTS_FAIL;
@@ -101,10 +120,17 @@ TTS_Error TTSClientPrivateCOMRPC::setTTSConfiguration(Configuration &config) {
         TTSLOG_ERROR("Couldn't set default configuration");
         return TTS_FAIL;
     }
+    m_configuration.update(config);
+    m_sessions.setSpeechRate(config.rate);
     return TTS_OK;
 }
 
-TTS_Error TTSClientPrivateCOMRPC::getTTSConfiguration(Configuration &config) {
+TTS_Error TTSClientPrivateCOMRPC::getTTSConfiguration(Configuration &config, bool force) {
+    if(!force && m_configuration.get(config))
+        return TTS_OK;
+
+    uint32_t generation = m_configuration.generation();
+
     Exchange::ITextToSpeech::Configuration ttsconfig;
     if(!TextToSpeechServiceCOMRPC::Instance()->getConfiguration(ttsconfig)) {
         TTSLOG_ERROR("Couldn't get default configuration");
@@ -116,6 +142,8 @@ TTS_Error TTSClientPrivateCOMRPC::getTTSConfiguration(Configuration &config) {
     config.voice = ttsconfig.voice;
     config.volume = (double) ttsconfig.volume;
     config.rate = ttsconfig.rate;
+    m_configuration.set(config, generation);
+    m_sessions.setSpeechRate(config.rate);
     return TTS_OK;
 }
 
@@ -140,59 +168,160 @@ bool TTSClientPrivateCOMRPC::isTTSEnabled(bool force) {
 
 uint32_t TTSClientPrivateCOMRPC::createSession(uint32_t appId, std::string appName, TTSSessionCallback *callback) {
     CHECK_CONNECTION_RETURN_ON_FAIL(0);
-    UNUSED(appName);
-
-    m_appId = appId;
     if(m_connectionCallback) {
         isTTSEnabled(true);
         m_connectionCallback->onTTSStateChanged(m_ttsEnabled);
     }
 
-    m_sessionCallback = callback;
-    if(m_sessionCallback)
-        m_sessionCallback->onTTSSessionCreated(m_appId, DEFAULT_SESSION_ID);
+    SessionTable::SessionPtr session = m_sessions.create(appId, appName, callback);
+    updateEventInterest();
+    if(callback)
+        callback->onTTSSessionCreated(appId, session->id);
 
-    return DEFAULT_SESSION_ID;
+    return session->id;
 }
 
 TTS_Error TTSClientPrivateCOMRPC::destroySession(uint32_t sessionId) {
-    UNUSED(sessionId);
-    m_sessionCallback  = nullptr;
+    if(!m_sessions.destroy(sessionId)) {
+        TTSLOG_ERROR("Session %u not found", sessionId);
+        return TTS_NO_SESSION_FOUND;
+    }
+    updateEventInterest();
+    return TTS_OK;
+}
+
+bool TTSClientPrivateCOMRPC::isSessionActiveForApp(uint32_t appId) {
+    return m_sessions.findForApp(appId) && ResourceArbiter::Instance().isActive(appId);
+}
+
+bool TTSClientPrivateCOMRPC::isActiveSession(uint32_t sessionId, bool forcefetch) {
+    UNUSED(forcefetch);
+    SessionTable::SessionPtr session = m_sessions.find(sessionId);
+    return session && ResourceArbiter::Instance().isActive(session->appId);
+}
+
+TTS_Error TTSClientPrivateCOMRPC::requestExtendedEvents(uint32_t sessionId, uint32_t extendedEvents) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    session->eventMask = extendedEvents;
+    updateEventInterest();
+    return TTS_OK;
+}
+
+void TTSClientPrivateCOMRPC::updateEventInterest() {
+    TextToSpeechServiceCOMRPC::Instance()->setEventInterest(this, m_sessions.eventInterest());
+}
+
+TTS_Error TTSClientPrivateCOMRPC::setResourcePriority(uint32_t sessionId, uint32_t priority) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    session->resourcePriority = priority;
     return TTS_OK;
 }
 
-TTS_Error TTSClientPrivateCOMRPC::speak(uint32_t sessionId, SpeechData& data) {
+TTS_Error TTSClientPrivateCOMRPC::setPreemptiveSpeak(uint32_t sessionId, bool preemptive) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    session->preemptive = preemptive;
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateCOMRPC::setSpeechChunking(uint32_t sessionId, bool enable) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    session->chunked = enable;
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateCOMRPC::setDuplicateSuppression(uint32_t sessionId, DuplicateSpeechPolicy policy, uint32_t windowMs) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    session->duplicates.configure(policy, windowMs);
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateCOMRPC::getDuplicateStats(uint32_t sessionId, DuplicateStats &stats) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    stats = session->duplicates.stats();
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateCOMRPC::setSpeakAhead(uint32_t sessionId, uint32_t depth) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    m_sessions.setSpeakAhead(session, depth);
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateCOMRPC::getSpeechEstimates(uint32_t sessionId, std::vector<SpeechEstimate> &estimates) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    estimates = m_sessions.estimates(session);
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateCOMRPC::speak(uint32_t sessionId, SpeechData& data, uint32_t *serviceSpeechId) {
     CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
-    UNUSED(sessionId);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
 
     TextToSpeechServiceCOMRPC::Instance()->registerSpeechEventHandlers(m_callsign);
+    return m_sessions.speak(session, data, serviceSpeechId);
+}
 
-    m_lastSpeechId = 0;
-    if(!TextToSpeechServiceCOMRPC::Instance()->speak(m_callsign, data.text, m_lastSpeechId)) {
-        return TTS_FAIL;
+TTS_Error TTSClientPrivateCOMRPC::speakBatch(uint32_t sessionId, std::vector<SpeechData> &data, std::vector<TTS_Error> &results) {
+    results.assign(data.size(), TTS_FAIL);
+    CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
+
+    TextToSpeechServiceCOMRPC::Instance()->registerSpeechEventHandlers(m_callsign);
+
+    if(!m_sessions.canBatch(session, data))
+        return m_sessions.speakEach(session, data, results);
+
+    std::vector<std::string> texts;
+    texts.reserve(data.size());
+    for(auto &speech : data)
+        texts.push_back(speech.text);
+
+    std::vector<uint32_t> speechids;
+    std::vector<bool> succeeded;
+    bool success = TextToSpeechServiceCOMRPC::Instance()->speakBatch(m_callsign, texts, speechids, succeeded);
+
+    std::vector<SessionTable::Submission> submitted;
+    for(size_t i = 0; i < data.size(); i++) {
+        if(succeeded[i]) {
+            results[i] = TTS_OK;
+            submitted.push_back({data[i], speechids[i]});
+        }
     }
 
-    bool success = m_requestedSpeeches.add(data.id, m_lastSpeechId);
-    TTSLOG_INFO("Requested speech with clientid-%d, serviceid-%d, is_duplicate_client_id=%d", data.id, m_lastSpeechId, !success);    
-    return TTS_OK;
+    size_t added = m_sessions.addSpeeches(session, submitted);
+    for(auto &speech : submitted)
+        TextToSpeechServiceCOMRPC::Instance()->registerSpeech(speech.serviceid, this);
+    TTSLOG_INFO("Requested %zu speeches in a batch, %zu accepted, %zu duplicate client ids", data.size(), submitted.size(), submitted.size() - added);
+    return success ? TTS_OK : TTS_FAIL;
+}
+
+TTS_Error TTSClientPrivateCOMRPC::speakStream(uint32_t sessionId, SpeechData& data, TextSource &source) {
+    CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
+
+    TextToSpeechServiceCOMRPC::Instance()->registerSpeechEventHandlers(m_callsign);
+    return m_sessions.speakStream(session, data, source);
 }
 
 TTS_Error TTSClientPrivateCOMRPC::abort(uint32_t sessionId, bool clearPending) {
     CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
-    UNUSED(sessionId);
-    UNUSED(clearPending);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
+
+    if(clearPending)
+        m_sessions.clearHeld(session);
 
     if(!m_ttsEnabled) {
         TTSLOG_WARNING("TTS is disabled, nothing to abort");
         return TTS_OK;
     }
 
-    if(m_requestedSpeeches.empty() || !m_lastSpeechId) {
+    if(!session->states.hasPending() || !session->lastSpeechId) {
         TTSLOG_WARNING("No speech in progress");
         return TTS_OK;
     }
 
-    if(!TextToSpeechServiceCOMRPC::Instance()->cancel(m_lastSpeechId)) {
+    uint32_t speechid = session->lastSpeechId;
+    if(!TextToSpeechServiceCOMRPC::Instance()->cancel(speechid)) {
         TTSLOG_ERROR("Coudn't abort");
         return TTS_FAIL;
     }
@@ -200,16 +329,21 @@ TTS_Error TTSClientPrivateCOMRPC::abort(uint32_t sessionId, bool clearPending) {
     return TTS_OK;
 }
 
+TTS_Error TTSClientPrivateCOMRPC::withdraw(uint32_t sessionId, uint32_t serviceSpeechId) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    return m_sessions.withdraw(session, serviceSpeechId) ? TTS_OK : TTS_FAIL;
+}
+
 TTS_Error TTSClientPrivateCOMRPC::pause(uint32_t sessionId, uint32_t speechId) {
     CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
-    UNUSED(sessionId);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
 
     if(!m_ttsEnabled) {
         TTSLOG_WARNING("TTS is disabled, nothing to pause");
         return TTS_OK;
     }
 
-    uint32_t serviceid = m_requestedSpeeches.getServiceId(speechId);
+    uint32_t serviceid = session->speeches.getServiceId(speechId);
     if(!serviceid) {
         TTSLOG_WARNING("No speech in progress");
         return TTS_OK;
@@ -220,19 +354,21 @@ TTS_Error TTSClientPrivateCOMRPC::pause(uint32_t sessionId, uint32_t speechId) {
         return TTS_FAIL;
     }
 
+    // The paused event may not be subscribed
+    session->states.update(speechId, SPEECH_IN_PROGRESS, SPEECH_PAUSED);
     return TTS_OK;
 }
 
 TTS_Error TTSClientPrivateCOMRPC::resume(uint32_t sessionId, uint32_t speechId) {
     CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
-    UNUSED(sessionId);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
 
     if(!m_ttsEnabled) {
         TTSLOG_WARNING("TTS is disabled, nothing to resume");
         return TTS_OK;
     }
 
-    uint32_t serviceid = m_requestedSpeeches.getServiceId(speechId);
+    uint32_t serviceid = session->speeches.getServiceId(speechId);
     if(!serviceid) {
         TTSLOG_WARNING("No speech in progress");
         return TTS_OK;
@@ -243,32 +379,47 @@ TTS_Error TTSClientPrivateCOMRPC::resume(uint32_t sessionId, uint32_t speechId)
         return TTS_FAIL;
     }
 
+    // The resumed event may not be subscribed
+    session->states.update(speechId, SPEECH_PAUSED, SPEECH_IN_PROGRESS);
     return TTS_OK;
 }
 
-bool TTSClientPrivateCOMRPC::isSpeaking(uint32_t sessionId) {
+bool TTSClientPrivateCOMRPC::isSpeaking(uint32_t sessionId, bool force) {
     CHECK_CONNECTION_RETURN_ON_FAIL(false);
-    UNUSED(sessionId);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, false);
+
+    bool speaking = false;
+    if(!force && session->states.isSpeaking(speaking))
+        return speaking;
 
-    if(m_requestedSpeeches.empty() || !m_lastSpeechId) {
+    if(session->speeches.empty() || !session->lastSpeechId) {
         TTSLOG_WARNING("No speech in progress");
         return false;
     }
 
+    uint32_t speechid = session->lastSpeechId;
     bool isspeaking = false;
-    if(!TextToSpeechServiceCOMRPC::Instance()->isSpeaking(m_lastSpeechId, isspeaking)) {
+    if(!TextToSpeechServiceCOMRPC::Instance()->isSpeaking(speechid, isspeaking)) {
         TTSLOG_ERROR("isspeaking query failed");
         return false;
     }
 
+    // Speeches are served in order, nothing requested before the last one can be
+    // in progress either, so the table is accurate again
+    if(!isspeaking)
+        session->states.resync();
+
     return isspeaking;
 }
 
-TTS_Error TTSClientPrivateCOMRPC::getSpeechState(uint32_t sessionId, uint32_t speechId, SpeechState &state) {
+TTS_Error TTSClientPrivateCOMRPC::getSpeechState(uint32_t sessionId, uint32_t speechId, SpeechState &state, bool force) {
     CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
-    UNUSED(sessionId);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
+
+    if(!force && session->states.get(speechId, state))
+        return TTS_OK;
 
-    uint32_t serviceid = m_requestedSpeeches.getServiceId(speechId);
+    uint32_t serviceid = session->speeches.getServiceId(speechId);
     if(!serviceid) {
         TTSLOG_WARNING("No speech in progress");
         return TTS_OK;
@@ -279,11 +430,57 @@ TTS_Error TTSClientPrivateCOMRPC::getSpeechState(uint32_t sessionId, uint32_t sp
         return TTS_FAIL;
     }
     state = (SpeechState) istate;
+    session->states.set(speechId, state);
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateCOMRPC::submit(SpeechData &data, uint32_t &speechid) {
+    speechid = 0;
+    if(!TextToSpeechServiceCOMRPC::Instance()->speak(m_callsign, data.text, speechid))
+        return TTS_FAIL;
+
+    TextToSpeechServiceCOMRPC::Instance()->registerSpeech(speechid, this);
     return TTS_OK;
 }
 
+bool TTSClientPrivateCOMRPC::cancel(uint32_t speechid) {
+    if(!TextToSpeechServiceCOMRPC::Instance()->cancel(speechid)) {
+        TTSLOG_ERROR("Coudn't cancel speech %u", speechid);
+        return false;
+    }
+    return true;
+}
+
+void TTSClientPrivateCOMRPC::onActivation() {
+    Configuration config;
+    if(getTTSConfiguration(config, true) == TTS_OK)
+        m_voiceCatalogue.prefetch({ config.language });
+
+    if(m_connectionCallback) {
+        TTSLOG_INFO("Got service connected event from TTS Manager for %p", this);
+        m_connectionCallback->onTTSServerConnected();
+    }
+}
+
+void TTSClientPrivateCOMRPC::onDeactivation() {
+    m_ttsEnabled = false;
+    m_configuration.invalidate();
+    m_voiceCatalogue.invalidate();
+    m_sessions.reset();
+    for(auto &session : m_sessions.sessions()) {
+        session->lastSpeechId = 0;
+        session->states.invalidate();
+    }
+    if(m_connectionCallback) {
+        TTSLOG_INFO("Got service disconnected event from TTS Manager for %p", this);
+        m_connectionCallback->onTTSServerClosed();
+    }
+}
+
 void TTSClientPrivateCOMRPC::onTTSStateChange(bool enabled) {
-    m_lastSpeechId = 0;
+    m_sessions.reset();
+    for(auto &session : m_sessions.sessions())
+        session->lastSpeechId = 0;
     m_ttsEnabled = enabled;
     if(m_connectionCallback) {
         TTSLOG_INFO("Got tts_state_changed event from TTS Manager for %p", this);
@@ -292,6 +489,8 @@ void TTSClientPrivateCOMRPC::onTTSStateChange(bool enabled) {
 }
 
 void TTSClientPrivateCOMRPC::onVoiceChange(std::string voice) {
+    m_configuration.invalidate();
+    m_voiceCatalogue.invalidate();
     if(m_connectionCallback) {
         TTSLOG_INFO("Got voice_changed event from TTS Manager %p, new voice = %s", this, voice.c_str());
         m_connectionCallback->onVoiceChanged(voice);
@@ -299,69 +498,35 @@ void TTSClientPrivateCOMRPC::onVoiceChange(std::string voice) {
 }
 
 void TTSClientPrivateCOMRPC::onSpeechStart(uint32_t serviceSpeechId) {
-    uint32_t clientSpeechId = m_requestedSpeeches.getClientId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        SpeechData data(clientSpeechId);
-        TTSLOG_INFO("Got started event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechStart(m_appId, DEFAULT_SESSION_ID, data);
-    }
+    m_sessions.dispatch(SessionTable::SpeechStart, serviceSpeechId);
 }
 
 void TTSClientPrivateCOMRPC::onSpeechPause(uint32_t serviceSpeechId) {
-    uint32_t clientSpeechId = m_requestedSpeeches.getClientId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got paused event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechPause(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::SpeechPause, serviceSpeechId);
 }
 
 void TTSClientPrivateCOMRPC::onSpeechResume(uint32_t serviceSpeechId) {
-    uint32_t clientSpeechId = m_requestedSpeeches.getClientId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got resumed event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechResume(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::SpeechResume, serviceSpeechId);
 }
 
 void TTSClientPrivateCOMRPC::onSpeechCancel(uint32_t serviceSpeechId) {
-    uint32_t clientSpeechId = m_requestedSpeeches.removeServiceId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got cancelled event from session %u, speech id %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechCancelled(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::SpeechCancel, serviceSpeechId);
 }
 
 void TTSClientPrivateCOMRPC::onSpeechInterrupt(uint32_t serviceSpeechId) {
-    uint32_t clientSpeechId = m_requestedSpeeches.removeServiceId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got interrupted event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechInterrupted(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::SpeechInterrupt, serviceSpeechId);
 }
 
 void TTSClientPrivateCOMRPC::onNetworkError(uint32_t serviceSpeechId) {
-    uint32_t clientSpeechId = m_requestedSpeeches.removeServiceId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got networkerror event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onNetworkError(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::NetworkError, serviceSpeechId);
 }
 
 void TTSClientPrivateCOMRPC::onPlaybackError(uint32_t serviceSpeechId) {
-    uint32_t clientSpeechId = m_requestedSpeeches.removeServiceId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got playbackerror event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onPlaybackError(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::PlaybackError, serviceSpeechId);
 }
 
 void TTSClientPrivateCOMRPC::onSpeechComplete(uint32_t serviceSpeechId) {
-    uint32_t clientSpeechId = m_requestedSpeeches.removeServiceId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        SpeechData data(clientSpeechId);
-        TTSLOG_INFO("Got spoke event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechComplete(m_appId, DEFAULT_SESSION_ID, data);
-    }
+    m_sessions.dispatch(SessionTable::SpeechComplete, serviceSpeechId);
 }
 
 } // namespace TTS
@@ -28,15 +28,20 @@ namespace TTS {
 
 #define UNUSED(x) (void)(x)
 
-#define DEFAULT_SESSION_ID 1
+#define GET_SESSION_RETURN_ON_FAIL(session, sessionId, ret) \
+    SessionTable::SessionPtr session = m_sessions.find(sessionId); \
+    if(!session) { \
+        TTSLOG_ERROR("Session %u not found", sessionId); \
+        return ret; \
+    }
 
 TTSClientPrivateFirebolt::TTSClientPrivateFirebolt(TTSConnectionCallback *callback, bool) :
     m_ttsEnabled(false),
     m_connectionCallback(callback),
-    m_sessionCallback(nullptr),
-    m_lastSpeechId(0),
-    m_appId(0),
-    m_firstQuery(true) {
+    m_firstQuery(true),
+    m_voiceCatalogue([this](std::string &language, std::vector<std::string> &voices) { return fetchVoices(language, voices) == TTS_OK; }),
+    m_sessions([this](SpeechData &data, uint32_t &speechid) { return submit(data, speechid); },
+        [this](uint32_t speechid) { return cancel(speechid); }) {
     const char* env_client = std::getenv("CLIENT_IDENTIFIER");
     if (env_client) {
         m_callsign.assign(env_client);
@@ -50,12 +55,22 @@ TTSClientPrivateFirebolt::TTSClientPrivateFirebolt(TTSConnectionCallback *callba
 
     if(TextToSpeechServiceFirebolt::Instance()->isActive() && m_connectionCallback)
         m_connectionCallback->onTTSServerConnected();     	
+
+    // Fill the configuration cache & voice catalogue up front, the reads are served locally from then on
+    if(TextToSpeechServiceFirebolt::Instance()->isActive()) {
+        Configuration config;
+        if(getTTSConfiguration(config, true) == TTS_OK)
+            m_voiceCatalogue.prefetch({ config.language });
+    }
 }
 
 TTSClientPrivateFirebolt::~TTSClientPrivateFirebolt() {
     TextToSpeechServiceFirebolt::Instance()->unregisterClient(this);
-    abort(DEFAULT_SESSION_ID, false);
-    destroySession(DEFAULT_SESSION_ID);
+    m_sessions.close();
+    for(auto &session : m_sessions.sessions()) {
+        abort(session->id, false);
+        destroySession(session->id);
+    }
 }
 
 bool TTSClientPrivateFirebolt::isTTSEnabled(bool force) {
@@ -78,14 +93,14 @@ bool TTSClientPrivateFirebolt::isTTSEnabled(bool force) {
 
 TTS_Error TTSClientPrivateFirebolt::pause(uint32_t sessionId, uint32_t speechId) {
     CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
-    UNUSED(sessionId);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
 
     if(!m_ttsEnabled) {
         TTSLOG_WARNING("TTS is disabled, nothing to pause");
         return TTS_OK;
     }
 
-    uint32_t serviceid = m_requestedSpeeches.getServiceId(speechId);
+    uint32_t serviceid = session->speeches.getServiceId(speechId);
     if(!serviceid) {
         TTSLOG_WARNING("No speech in progress");
         return TTS_OK;
@@ -96,10 +111,16 @@ TTS_Error TTSClientPrivateFirebolt::pause(uint32_t sessionId, uint32_t speechId)
         return TTS_FAIL;
     }
 
+    // The paused event may not be subscribed
+    session->states.update(speechId, SPEECH_IN_PROGRESS, SPEECH_PAUSED);
     return TTS_OK;
 }
 
 TTS_Error TTSClientPrivateFirebolt::listVoices(std::string &language, std::vector<std::string> &voices) {
+    return m_voiceCatalogue.lookup(language, voices) ? TTS_OK : TTS_FAIL;
+}
+
+TTS_Error TTSClientPrivateFirebolt::fetchVoices(std::string &language, std::vector<std::string> &voices) {
     if(!TextToSpeechServiceFirebolt::Instance()->listVoices(language,voices)) {
         TTSLOG_ERROR("Couldn't retrieve voice list");
         return TTS_FAIL;
@@ -114,7 +135,7 @@ TTS_Error TTSClientPrivateFirebolt::enableTTS(bool enable) {
 
 TTS_Error TTSClientPrivateFirebolt::resume(uint32_t sessionId, uint32_t speechId) {
     CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
-    UNUSED(sessionId);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
 
     if(!m_ttsEnabled) {
         TTSLOG_WARNING("TTS is disabled, nothing to resume");
@@ -123,7 +144,7 @@ TTS_Error TTSClientPrivateFirebolt::resume(uint32_t sessionId, uint32_t speechId
 
     // Firebolt Expecting speechId
     
-    uint32_t serviceid = m_requestedSpeeches.getServiceId(speechId);
+    uint32_t serviceid = session->speeches.getServiceId(speechId);
     if(!serviceid) {
         TTSLOG_WARNING("No speech in progress");
         return TTS_OK;
@@ -134,32 +155,47 @@ TTS_Error TTSClientPrivateFirebolt::resume(uint32_t sessionId, uint32_t speechId
         return TTS_FAIL;
     }
 
+    // The resumed event may not be subscribed
+    session->states.update(speechId, SPEECH_PAUSED, SPEECH_IN_PROGRESS);
     return TTS_OK;
 }
 
-bool TTSClientPrivateFirebolt::isSpeaking(uint32_t sessionId) {
+bool TTSClientPrivateFirebolt::isSpeaking(uint32_t sessionId, bool force) {
     CHECK_CONNECTION_RETURN_ON_FAIL(false);
-    UNUSED(sessionId);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, false);
+
+    bool speaking = false;
+    if(!force && session->states.isSpeaking(speaking))
+        return speaking;
 
-    if(m_requestedSpeeches.empty() || !m_lastSpeechId) {
+    if(session->speeches.empty() || !session->lastSpeechId) {
         TTSLOG_WARNING("No speech in progress");
         return false;
     }
 
+    uint32_t speechid = session->lastSpeechId;
     bool isspeaking = false;
-    if(!TextToSpeechServiceFirebolt::Instance()->isSpeaking(m_lastSpeechId, isspeaking)) {
+    if(!TextToSpeechServiceFirebolt::Instance()->isSpeaking(speechid, isspeaking)) {
         TTSLOG_ERROR("isspeaking query failed");
         return false;
     }
 
+    // Speeches are served in order, nothing requested before the last one can be
+    // in progress either, so the table is accurate again
+    if(!isspeaking)
+        session->states.resync();
+
     return isspeaking;
 }
 
-TTS_Error TTSClientPrivateFirebolt::getSpeechState(uint32_t sessionId, uint32_t speechId, SpeechState &state) {
+TTS_Error TTSClientPrivateFirebolt::getSpeechState(uint32_t sessionId, uint32_t speechId, SpeechState &state, bool force) {
     CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
-    UNUSED(sessionId);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
+
+    if(!force && session->states.get(speechId, state))
+        return TTS_OK;
 
-    uint32_t serviceid = m_requestedSpeeches.getServiceId(speechId);
+    uint32_t serviceid = session->speeches.getServiceId(speechId);
     
     if(!serviceid) {
         TTSLOG_WARNING("No speech in progress");
@@ -176,47 +212,164 @@ TTS_Error TTSClientPrivateFirebolt::getSpeechState(uint32_t sessionId, uint32_t
     return TTS_OK;  
 }
 
+TTS_Error TTSClientPrivateFirebolt::submit(SpeechData &data, uint32_t &speechid) {
+    speechid = 0;
+    if(!TextToSpeechServiceFirebolt::Instance()->speak(m_callsign, data.text, speechid))
+        return TTS_FAIL;
+
+    TextToSpeechServiceFirebolt::Instance()->registerSpeech(speechid, this);
+    return TTS_OK;
+}
+
+bool TTSClientPrivateFirebolt::cancel(uint32_t speechid) {
+    if(!TextToSpeechServiceFirebolt::Instance()->cancel(speechid)) {
+        TTSLOG_ERROR("Coudn't cancel speech %u", speechid);
+        return false;
+    }
+    return true;
+}
+
 TTS_Error TTSClientPrivateFirebolt::destroySession(uint32_t sessionId) {
-    UNUSED(sessionId);
-    m_sessionCallback  = nullptr;
+    if(!m_sessions.destroy(sessionId)) {
+        TTSLOG_ERROR("Session %u not found", sessionId);
+        return TTS_NO_SESSION_FOUND;
+    }
+    updateEventInterest();
+    return TTS_OK;
+}
+
+bool TTSClientPrivateFirebolt::isSessionActiveForApp(uint32_t appId) {
+    return m_sessions.findForApp(appId) && ResourceArbiter::Instance().isActive(appId);
+}
+
+bool TTSClientPrivateFirebolt::isActiveSession(uint32_t sessionId, bool forcefetch) {
+    UNUSED(forcefetch);
+    SessionTable::SessionPtr session = m_sessions.find(sessionId);
+    return session && ResourceArbiter::Instance().isActive(session->appId);
+}
+
+TTS_Error TTSClientPrivateFirebolt::requestExtendedEvents(uint32_t sessionId, uint32_t extendedEvents) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    session->eventMask = extendedEvents;
+    updateEventInterest();
+    return TTS_OK;
+}
+
+void TTSClientPrivateFirebolt::updateEventInterest() {
+    TextToSpeechServiceFirebolt::Instance()->setEventInterest(this, m_sessions.eventInterest());
+}
+
+TTS_Error TTSClientPrivateFirebolt::setResourcePriority(uint32_t sessionId, uint32_t priority) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    session->resourcePriority = priority;
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateFirebolt::setPreemptiveSpeak(uint32_t sessionId, bool preemptive) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    session->preemptive = preemptive;
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateFirebolt::setSpeechChunking(uint32_t sessionId, bool enable) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    session->chunked = enable;
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateFirebolt::setDuplicateSuppression(uint32_t sessionId, DuplicateSpeechPolicy policy, uint32_t windowMs) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    session->duplicates.configure(policy, windowMs);
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateFirebolt::getDuplicateStats(uint32_t sessionId, DuplicateStats &stats) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    stats = session->duplicates.stats();
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateFirebolt::setSpeakAhead(uint32_t sessionId, uint32_t depth) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    m_sessions.setSpeakAhead(session, depth);
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateFirebolt::getSpeechEstimates(uint32_t sessionId, std::vector<SpeechEstimate> &estimates) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    estimates = m_sessions.estimates(session);
     return TTS_OK;
 }
 
 // speak API requires the SpeechData parameter; Firebolt is not using this
-TTS_Error TTSClientPrivateFirebolt::speak(uint32_t sessionId, SpeechData& data) {
+TTS_Error TTSClientPrivateFirebolt::speak(uint32_t sessionId, SpeechData& data, uint32_t *serviceSpeechId) {
     CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
-    UNUSED(sessionId);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
 
     /*if(!m_ttsEnabled) {
         TTSLOG_ERROR("TTS is disabled, can't speak");
         return TTS_NOT_ENABLED;
     }*/
-    m_lastSpeechId = 0;
-    if(!TextToSpeechServiceFirebolt::Instance()->speak(m_callsign, data.text, m_lastSpeechId)) {
-        return TTS_FAIL;
+    return m_sessions.speak(session, data, serviceSpeechId);
+}
+
+TTS_Error TTSClientPrivateFirebolt::speakBatch(uint32_t sessionId, std::vector<SpeechData> &data, std::vector<TTS_Error> &results) {
+    results.assign(data.size(), TTS_FAIL);
+    CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
+
+    if(!m_sessions.canBatch(session, data))
+        return m_sessions.speakEach(session, data, results);
+
+    std::vector<std::string> texts;
+    texts.reserve(data.size());
+    for(auto &speech : data)
+        texts.push_back(speech.text);
+
+    std::vector<uint32_t> speechids;
+    std::vector<bool> succeeded;
+    bool success = TextToSpeechServiceFirebolt::Instance()->speakBatch(m_callsign, texts, speechids, succeeded);
+
+    std::vector<SessionTable::Submission> submitted;
+    for(size_t i = 0; i < data.size(); i++) {
+        if(succeeded[i]) {
+            results[i] = TTS_OK;
+            submitted.push_back({data[i], speechids[i]});
+        }
     }
 
-    bool success = m_requestedSpeeches.add(data.id, m_lastSpeechId);
-    TTSLOG_INFO("Requested speech with clientid-%d, serviceid-%d, is_duplicate_client_id=%d", data.id, m_lastSpeechId, !success);    
-    return TTS_OK;   
+    size_t added = m_sessions.addSpeeches(session, submitted);
+    for(auto &speech : submitted)
+        TextToSpeechServiceFirebolt::Instance()->registerSpeech(speech.serviceid, this);
+    TTSLOG_INFO("Requested %zu speeches in a batch, %zu accepted, %zu duplicate client ids", data.size(), submitted.size(), submitted.size() - added);
+    return success ? TTS_OK : TTS_FAIL;
+}
+
+TTS_Error TTSClientPrivateFirebolt::speakStream(uint32_t sessionId, SpeechData& data, TextSource &source) {
+    CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
+    return m_sessions.speakStream(session, data, source);
 }
 
 TTS_Error TTSClientPrivateFirebolt::abort(uint32_t sessionId, bool clearPending) {
     CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
-    UNUSED(sessionId);
-    UNUSED(clearPending);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
+
+    if(clearPending)
+        m_sessions.clearHeld(session);
 
     if(!m_ttsEnabled) {
         TTSLOG_WARNING("TTS is disabled, nothing to abort");
         return TTS_OK;
     }
 
-    if(m_requestedSpeeches.empty() || !m_lastSpeechId) {
+    if(!session->states.hasPending() || !session->lastSpeechId) {
         TTSLOG_WARNING("No speech in progress");
         return TTS_OK;
     }
 
-    if(!TextToSpeechServiceFirebolt::Instance()->cancel(m_lastSpeechId)) {
+    uint32_t speechid = session->lastSpeechId;
+    if(!TextToSpeechServiceFirebolt::Instance()->cancel(speechid)) {
         TTSLOG_ERROR("Coudn't abort");
         return TTS_FAIL;
     }
@@ -224,6 +377,11 @@ TTS_Error TTSClientPrivateFirebolt::abort(uint32_t sessionId, bool clearPending)
     return TTS_OK;
 }
 
+TTS_Error TTSClientPrivateFirebolt::withdraw(uint32_t sessionId, uint32_t serviceSpeechId) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    return m_sessions.withdraw(session, serviceSpeechId) ? TTS_OK : TTS_FAIL;
+}
+
 TTS_Error TTSClientPrivateFirebolt::setTTSConfiguration(Configuration &config) {
     Firebolt::TextToSpeech::TTSConfiguration ttsConfiguration;
 
@@ -237,10 +395,17 @@ TTS_Error TTSClientPrivateFirebolt::setTTSConfiguration(Configuration &config) {
         TTSLOG_ERROR("Couldn't set default configuration");
         return TTS_FAIL;
     }
+    m_configuration.update(config);
+    m_sessions.setSpeechRate(config.rate);
     return TTS_OK;
 }
 
-TTS_Error TTSClientPrivateFirebolt::getTTSConfiguration(Configuration &config) {
+TTS_Error TTSClientPrivateFirebolt::getTTSConfiguration(Configuration &config, bool force) {
+    if(!force && m_configuration.get(config))
+        return TTS_OK;
+
+    uint32_t generation = m_configuration.generation();
+
     Firebolt::TextToSpeech::TTSConfiguration ttsConfiguration;
     if(!TextToSpeechServiceFirebolt::Instance()->getConfiguration(ttsConfiguration)) {
         TTSLOG_ERROR("Couldn't get default configuration");
@@ -252,28 +417,30 @@ TTS_Error TTSClientPrivateFirebolt::getTTSConfiguration(Configuration &config) {
     config.voice = ttsConfiguration.voice.value();
     config.volume = ttsConfiguration.volume.value();
     config.rate = ttsConfiguration.rate.value();
+    m_configuration.set(config, generation);
+    m_sessions.setSpeechRate(config.rate);
     return TTS_OK;
 }
 
 uint32_t TTSClientPrivateFirebolt::createSession(uint32_t appId, std::string appName, TTSSessionCallback *callback) {
     CHECK_CONNECTION_RETURN_ON_FAIL(0);
-    UNUSED(appName);
-
-    m_appId = appId;
     if(m_connectionCallback) {
         isTTSEnabled(true);
         m_connectionCallback->onTTSStateChanged(m_ttsEnabled);
     }
 
-    m_sessionCallback = callback;
-    if(m_sessionCallback)
-        m_sessionCallback->onTTSSessionCreated(m_appId, DEFAULT_SESSION_ID);
+    SessionTable::SessionPtr session = m_sessions.create(appId, appName, callback);
+    updateEventInterest();
+    if(callback)
+        callback->onTTSSessionCreated(appId, session->id);
 
-    return DEFAULT_SESSION_ID;
+    return session->id;
 }
 
 void TTSClientPrivateFirebolt::onTTSStateChange(bool enabled) {
-    m_lastSpeechId = 0;
+    m_sessions.reset();
+    for(auto &session : m_sessions.sessions())
+        session->lastSpeechId = 0;
     m_ttsEnabled = enabled;
     if(m_connectionCallback) {
         TTSLOG_INFO("Got tts_state_changed event from TTS Manager for %p", this);
@@ -282,6 +449,8 @@ void TTSClientPrivateFirebolt::onTTSStateChange(bool enabled) {
 }
 
 void TTSClientPrivateFirebolt::onVoiceChange(std::string voice) {
+    m_configuration.invalidate();
+    m_voiceCatalogue.invalidate();
     if(m_connectionCallback) {
         TTSLOG_INFO("Got voice_changed event from TTS Manager %p, new voice = %s", this, voice.c_str());
         m_connectionCallback->onVoiceChanged(voice);
@@ -289,69 +458,35 @@ void TTSClientPrivateFirebolt::onVoiceChange(std::string voice) {
 }
 
 void TTSClientPrivateFirebolt::onSpeechStart(uint32_t serviceSpeechId) {
-    uint32_t clientSpeechId = m_requestedSpeeches.getClientId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        SpeechData data(clientSpeechId);
-        TTSLOG_INFO("Got started event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechStart(m_appId, DEFAULT_SESSION_ID, data);
-    }
+    m_sessions.dispatch(SessionTable::SpeechStart, serviceSpeechId);
 }
 
 void TTSClientPrivateFirebolt::onSpeechPause(uint32_t serviceSpeechId) {
-    uint32_t clientSpeechId = m_requestedSpeeches.getClientId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got paused event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechPause(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::SpeechPause, serviceSpeechId);
 }
 
 void TTSClientPrivateFirebolt::onSpeechResume(uint32_t serviceSpeechId) {
-    uint32_t clientSpeechId = m_requestedSpeeches.getClientId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got resumed event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechResume(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::SpeechResume, serviceSpeechId);
 }
 
 void TTSClientPrivateFirebolt::onSpeechCancel(uint32_t serviceSpeechId) {
-    uint32_t clientSpeechId = m_requestedSpeeches.removeServiceId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got cancelled event from session %u, speech id %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechCancelled(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::SpeechCancel, serviceSpeechId);
 }
 
-void TTSClientPrivateFirebolt::onSpeechInterrupt(uint32_t speeechId){
-    uint32_t clientSpeechId = m_requestedSpeeches.removeServiceId(speeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        //TTSLOG_INFO("Got interrupted event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechInterrupted(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+void TTSClientPrivateFirebolt::onSpeechInterrupt(uint32_t serviceSpeechId){
+    m_sessions.dispatch(SessionTable::SpeechInterrupt, serviceSpeechId);
 }
 
-void TTSClientPrivateFirebolt::onNetworkError(uint32_t speeechId) {
-    uint32_t clientSpeechId = m_requestedSpeeches.removeServiceId(speeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        //TTSLOG_INFO("Got networkerror event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onNetworkError(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+void TTSClientPrivateFirebolt::onNetworkError(uint32_t serviceSpeechId) {
+    m_sessions.dispatch(SessionTable::NetworkError, serviceSpeechId);
 }
 
 void TTSClientPrivateFirebolt::onPlaybackError(uint32_t serviceSpeechId) {
-    uint32_t clientSpeechId = m_requestedSpeeches.removeServiceId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got playbackerror event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onPlaybackError(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::PlaybackError, serviceSpeechId);
 }
 
 void TTSClientPrivateFirebolt::onSpeechComplete(uint32_t serviceSpeechId) {
-    uint32_t clientSpeechId = m_requestedSpeeches.removeServiceId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        SpeechData data(clientSpeechId);
-        TTSLOG_INFO("Got spoke event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechComplete(m_appId, DEFAULT_SESSION_ID, data);
-    }
+    m_sessions.dispatch(SessionTable::SpeechComplete, serviceSpeechId);
 }
 
 } // namespace TTS
@@ -28,79 +28,16 @@
 #include "TTSClient.h"
 #include "TTSClientPrivateInterface.h"
 #include "TextToSpeechServiceFirebolt.h"
+#include "ConfigurationCache.h"
+#include "VoiceCatalogue.h"
+#include "SessionTable.h"
+#include "ResourceArbiter.h"
 #include "TTSCommon.h"
 
 using namespace TTSFirebolt;
 
 namespace TTS {
 
-class FireboltSpeechRequestMap {
-public:
-    bool add(uint32_t clientid, uint32_t serviceid) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        if(m_map.find(clientid) == m_map.end()) {
-            m_map[clientid] = serviceid;
-            return true;
-        }
-        return false;
-    }
-
-    uint32_t getServiceId(uint32_t clientid) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        for(auto it = m_map.begin(); it != m_map.end(); ++it)
-            if(it->first == clientid)
-                return it->second;
-        return 0;
-    }
-
-    uint32_t getClientId(uint32_t serviceid) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        for(auto it = m_map.begin(); it != m_map.end(); ++it)
-            if(it->second == serviceid)
-                return it->first;
-        return 0;
-    }
-
-    uint32_t removeClientId(uint32_t clientid) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        for(auto it = m_map.begin(); it != m_map.end(); ++it) {
-            if(it->first == clientid) {
-                uint32_t serviceid = it->second;
-                m_map.erase(it);
-                return serviceid;
-            }
-        }
-        return 0;
-    }
-
-    uint32_t removeServiceId(uint32_t serviceid) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        for(auto it = m_map.begin(); it != m_map.end(); ++it) {
-            if(it->second == serviceid) {
-                uint32_t clientid = it->first;
-                m_map.erase(it);
-                return clientid;
-            }
-        }
-        return 0;
-    }
-
-    bool empty() {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        return m_map.empty();
-    }
-
-    void clear() {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_map.clear();
-    }
-
-private:
-    std::map<uint32_t, uint32_t> m_map;
-    std::mutex m_mutex;
-
-};
-
 class TTSClientPrivateFirebolt : public TTSClientPrivateInterface,TextToSpeechServiceFirebolt::Client {
 
 public:
@@ -111,30 +48,38 @@ public:
     TTS_Error enableTTS(bool enable) override;
     TTS_Error listVoices(std::string &language, std::vector<std::string> &voices) override;
     TTS_Error setTTSConfiguration(Configuration &config) override;
-    TTS_Error getTTSConfiguration(Configuration &config) override;
+    TTS_Error getTTSConfiguration(Configuration &config, bool forcefetch=false) override;
     bool isTTSEnabled(bool forcefetch) override;
-    bool isSessionActiveForApp(uint32_t) override { return true; }
+    bool isSessionActiveForApp(uint32_t appId) override;
 
     // Resource management APIs
-    TTS_Error acquireResource(uint32_t) override { return TTS_OK; }
-    TTS_Error claimResource(uint32_t) override { return TTS_OK; }
-    TTS_Error releaseResource(uint32_t) override { return TTS_OK; }
+    TTS_Error acquireResource(uint32_t appId) override { return ResourceArbiter::Instance().acquire(appId); }
+    TTS_Error claimResource(uint32_t appId) override { return ResourceArbiter::Instance().claim(appId); }
+    TTS_Error releaseResource(uint32_t appId) override { return ResourceArbiter::Instance().release(appId); }
+    TTS_Error setResourcePriority(uint32_t sessionId, uint32_t priority) override;
 
     // Session management APIs
-    // Restricted to single session now
     uint32_t /*sessionId*/ createSession(uint32_t sessionId, std::string appName, TTSSessionCallback *callback) override;
     TTS_Error destroySession(uint32_t sessionId) override;
-    bool isActiveSession(uint32_t, bool forcefetch=false) override { (void)forcefetch; return true; }
-    TTS_Error setPreemptiveSpeak(uint32_t, bool preemptive=true) override { (void)preemptive; return TTS_OK; }
-    TTS_Error requestExtendedEvents(uint32_t, uint32_t) override { return TTS_OK; }
+    bool isActiveSession(uint32_t sessionId, bool forcefetch=false) override;
+    TTS_Error setPreemptiveSpeak(uint32_t sessionId, bool preemptive=true) override;
+    TTS_Error setSpeechChunking(uint32_t sessionId, bool enable) override;
+    TTS_Error setDuplicateSuppression(uint32_t sessionId, DuplicateSpeechPolicy policy, uint32_t windowMs) override;
+    TTS_Error getDuplicateStats(uint32_t sessionId, DuplicateStats &stats) override;
+    TTS_Error setSpeakAhead(uint32_t sessionId, uint32_t depth) override;
+    TTS_Error getSpeechEstimates(uint32_t sessionId, std::vector<SpeechEstimate> &estimates) override;
+    TTS_Error requestExtendedEvents(uint32_t sessionId, uint32_t extendedEvents) override;
 
     // Speak APIs
-    TTS_Error speak(uint32_t sessionId, SpeechData& data) override;
+    TTS_Error speak(uint32_t sessionId, SpeechData& data, uint32_t *serviceSpeechId = nullptr) override;
+    TTS_Error speakBatch(uint32_t sessionId, std::vector<SpeechData> &data, std::vector<TTS_Error> &results) override;
+    TTS_Error speakStream(uint32_t sessionId, SpeechData& data, TextSource &source) override;
     TTS_Error pause(uint32_t sessionId, uint32_t speechId = 0) override;
     TTS_Error resume(uint32_t sessionId, uint32_t speechId = 0) override;
     TTS_Error abort(uint32_t sessionId, bool clearPending) override;
-    bool isSpeaking(uint32_t sessionId) override;
-    TTS_Error getSpeechState(uint32_t sessionId, uint32_t speechId, SpeechState &state) override;
+    TTS_Error withdraw(uint32_t sessionId, uint32_t serviceSpeechId) override;
+    bool isSpeaking(uint32_t sessionId, bool forcefetch=false) override;
+    TTS_Error getSpeechState(uint32_t sessionId, uint32_t speechId, SpeechState &state, bool forcefetch=false) override;
 
     // TextToSpeechService::Client interfaces
     //void onActivation(); override;
@@ -152,15 +97,19 @@ public:
     
 private:
     TTSClientPrivateFirebolt(TTSClientPrivateFirebolt&) = delete;
+    TTS_Error fetchVoices(std::string &language, std::vector<std::string> &voices);
+    TTS_Error submit(SpeechData &data, uint32_t &speechid);
+    bool cancel(uint32_t speechid);
+    // Subscribes the service to the events the sessions asked for
+    void updateEventInterest();
 
     bool m_ttsEnabled;
     TTSConnectionCallback *m_connectionCallback;
-    TTSSessionCallback *m_sessionCallback;
 
-    FireboltSpeechRequestMap m_requestedSpeeches;
-    uint32_t m_lastSpeechId;
-    uint32_t m_appId;
     bool m_firstQuery;
+    ConfigurationCache m_configuration;
+    VoiceCatalogue m_voiceCatalogue;
+    SessionTable m_sessions;
     std::string m_callsign;
 };
 
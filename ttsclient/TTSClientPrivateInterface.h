@@ -31,7 +31,7 @@ public:
     virtual TTS_Error enableTTS(bool enable) = 0;
     virtual TTS_Error listVoices(std::string &language, std::vector<std::string> &voices) = 0;
     virtual TTS_Error setTTSConfiguration(Configuration &config) = 0;
-    virtual TTS_Error getTTSConfiguration(Configuration &config) = 0;
+    virtual TTS_Error getTTSConfiguration(Configuration &config, bool forcefetch=false) = 0;
     virtual bool isTTSEnabled(bool forcefetch=false) = 0;
     virtual bool isSessionActiveForApp(uint32_t appId) = 0;
 
@@ -39,21 +39,31 @@ public:
     virtual TTS_Error acquireResource(uint32_t appId) = 0;
     virtual TTS_Error claimResource(uint32_t appId) = 0;
     virtual TTS_Error releaseResource(uint32_t appId) = 0;
+    virtual TTS_Error setResourcePriority(uint32_t sessionId, uint32_t priority) = 0;
 
     // Session management APIs
     virtual uint32_t /*sessionId*/ createSession(uint32_t sessionId, std::string appName, TTSSessionCallback *callback) = 0;
     virtual TTS_Error destroySession(uint32_t sessionId) = 0;
     virtual bool isActiveSession(uint32_t sessionId, bool forcefetch=false) = 0;
     virtual TTS_Error setPreemptiveSpeak(uint32_t sessionId, bool preemptive=true) = 0;
+    virtual TTS_Error setSpeechChunking(uint32_t sessionId, bool enable) = 0;
+    virtual TTS_Error setDuplicateSuppression(uint32_t sessionId, DuplicateSpeechPolicy policy, uint32_t windowMs) = 0;
+    virtual TTS_Error getDuplicateStats(uint32_t sessionId, DuplicateStats &stats) = 0;
+    virtual TTS_Error setSpeakAhead(uint32_t sessionId, uint32_t depth) = 0;
+    virtual TTS_Error getSpeechEstimates(uint32_t sessionId, std::vector<SpeechEstimate> &estimates) = 0;
     virtual TTS_Error requestExtendedEvents(uint32_t sessionId, uint32_t extendedEvents) = 0;
 
     // Speak APIs
-    virtual TTS_Error speak(uint32_t sessionId, SpeechData& data) = 0;
+    virtual TTS_Error speak(uint32_t sessionId, SpeechData& data, uint32_t *serviceSpeechId = nullptr) = 0;
+    virtual TTS_Error speakBatch(uint32_t sessionId, std::vector<SpeechData> &data, std::vector<TTS_Error> &results) = 0;
+    virtual TTS_Error speakStream(uint32_t sessionId, SpeechData& data, TextSource &source) = 0;
     virtual TTS_Error pause(uint32_t sessionId, uint32_t speechId = 0) = 0;
     virtual TTS_Error resume(uint32_t sessionId, uint32_t speechId = 0) = 0;
     virtual TTS_Error abort(uint32_t sessionId, bool clearPending) = 0;
-    virtual bool isSpeaking(uint32_t sessionId) = 0;
-    virtual TTS_Error getSpeechState(uint32_t sessionId, uint32_t speechId, SpeechState &state) = 0;
+    // Cancels the speech unless it started already, TTS_FAIL when it did (or is gone)
+    virtual TTS_Error withdraw(uint32_t sessionId, uint32_t serviceSpeechId) = 0;
+    virtual bool isSpeaking(uint32_t sessionId, bool forcefetch=false) = 0;
+    virtual TTS_Error getSpeechState(uint32_t sessionId, uint32_t speechId, SpeechState &state, bool forcefetch=false) = 0;
 };
 
 } // namespace TTS
@@ -40,17 +40,22 @@ namespace TTS {
 
 #define UNUSED(x) (void)(x)
 
-#define DEFAULT_SESSION_ID 1
+#define GET_SESSION_RETURN_ON_FAIL(session, sessionId, ret) \
+    SessionTable::SessionPtr session = m_sessions.find(sessionId); \
+    if(!session) { \
+        TTSLOG_ERROR("Session %u not found", sessionId); \
+        return ret; \
+    }
 
 // --- //
 
 TTSClientPrivateJsonRPC::TTSClientPrivateJsonRPC(TTSConnectionCallback *callback, bool) :
     m_ttsEnabled(false),
     m_connectionCallback(callback),
-    m_sessionCallback(nullptr),
-    m_lastSpeechId(0),
-    m_appId(0),
-    m_firstQuery(true) {
+    m_firstQuery(true),
+    m_voiceCatalogue([this](std::string &language, std::vector<std::string> &voices) { return fetchVoices(language, voices) == TTS_OK; }),
+    m_sessions([this](SpeechData &data, uint32_t &speechid) { return submit(data, speechid); },
+        [this](uint32_t speechid) { return cancel(speechid); }) {
     TextToSpeechService::Instance()->initialize();
     TextToSpeechService::Instance()->registerClient(this);
     TextToSpeechService::Instance()->restartServiceOnCrash(false);
@@ -65,12 +70,22 @@ TTSClientPrivateJsonRPC::TTSClientPrivateJsonRPC(TTSConnectionCallback *callback
 
     if(TextToSpeechService::Instance()->isActive() && m_connectionCallback)
         m_connectionCallback->onTTSServerConnected();
+
+    // Fill the configuration cache & voice catalogue up front, the reads are served locally from then on
+    if(TextToSpeechService::Instance()->isActive()) {
+        Configuration config;
+        if(getTTSConfiguration(config, true) == TTS_OK)
+            m_voiceCatalogue.prefetch({ config.language });
+    }
 }
 
 TTSClientPrivateJsonRPC::~TTSClientPrivateJsonRPC() {
     TextToSpeechService::Instance()->unregisterClient(this);
-    abort(DEFAULT_SESSION_ID, false);
-    destroySession(DEFAULT_SESSION_ID);
+    m_sessions.close();
+    for(auto &session : m_sessions.sessions()) {
+        abort(session->id, false);
+        destroySession(session->id);
+    }
 }
 
 TTS_Error TTSClientPrivateJsonRPC::enableTTS(bool enable) {
@@ -85,6 +100,10 @@ TTS_Error TTSClientPrivateJsonRPC::enableTTS(bool enable) {
 }
 
 TTS_Error TTSClientPrivateJsonRPC::listVoices(std::string &language, std::vector<std::string> &voices) {
+    return m_voiceCatalogue.lookup(language, voices) ? TTS_OK : TTS_FAIL;
+}
+
+TTS_Error TTSClientPrivateJsonRPC::fetchVoices(std::string &language, std::vector<std::string> &voices) {
     JsonObject request, response;
     request["language"] = language;
     if(!TextToSpeechService::Instance()->invoke("listvoices", request, response)) {
@@ -116,10 +135,17 @@ TTS_Error TTSClientPrivateJsonRPC::setTTSConfiguration(Configuration &config) {
         return TTS_FAIL;
     }
 
+    m_configuration.update(config);
+    m_sessions.setSpeechRate(config.rate);
     return TTS_OK;
 }
 
-TTS_Error TTSClientPrivateJsonRPC::getTTSConfiguration(Configuration &config) {
+TTS_Error TTSClientPrivateJsonRPC::getTTSConfiguration(Configuration &config, bool force) {
+    if(!force && m_configuration.get(config))
+        return TTS_OK;
+
+    uint32_t generation = m_configuration.generation();
+
     JsonObject request, response;
     if(!TextToSpeechService::Instance()->invoke("getttsconfiguration", request, response)) {
         TTSLOG_ERROR("Couldn't get configuration");
@@ -133,6 +159,8 @@ TTS_Error TTSClientPrivateJsonRPC::getTTSConfiguration(Configuration &config) {
     config.volume = std::stod(response["volume"].String());
     config.rate = response["rate"].Number();
 
+    m_configuration.set(config, generation);
+    m_sessions.setSpeechRate(config.rate);
     return TTS_OK;
 }
 
@@ -159,30 +187,94 @@ bool TTSClientPrivateJsonRPC::isTTSEnabled(bool force) {
 
 uint32_t TTSClientPrivateJsonRPC::createSession(uint32_t appId, std::string appName, TTSSessionCallback *callback) {
     CHECK_CONNECTION_RETURN_ON_FAIL(0);
-    UNUSED(appName);
-
-    m_appId = appId;
     if(m_connectionCallback) {
         isTTSEnabled(true);
         m_connectionCallback->onTTSStateChanged(m_ttsEnabled);
     }
 
-    m_sessionCallback = callback;
-    if(m_sessionCallback)
-        m_sessionCallback->onTTSSessionCreated(m_appId, DEFAULT_SESSION_ID);
+    SessionTable::SessionPtr session = m_sessions.create(appId, appName, callback);
+    updateEventInterest();
+    if(callback)
+        callback->onTTSSessionCreated(appId, session->id);
 
-    return DEFAULT_SESSION_ID;
+    return session->id;
 }
 
 TTS_Error TTSClientPrivateJsonRPC::destroySession(uint32_t sessionId) {
-    UNUSED(sessionId);
-    m_sessionCallback  = nullptr;
+    if(!m_sessions.destroy(sessionId)) {
+        TTSLOG_ERROR("Session %u not found", sessionId);
+        return TTS_NO_SESSION_FOUND;
+    }
+    updateEventInterest();
+    return TTS_OK;
+}
+
+bool TTSClientPrivateJsonRPC::isSessionActiveForApp(uint32_t appId) {
+    return m_sessions.findForApp(appId) && ResourceArbiter::Instance().isActive(appId);
+}
+
+bool TTSClientPrivateJsonRPC::isActiveSession(uint32_t sessionId, bool forcefetch) {
+    UNUSED(forcefetch);
+    SessionTable::SessionPtr session = m_sessions.find(sessionId);
+    return session && ResourceArbiter::Instance().isActive(session->appId);
+}
+
+TTS_Error TTSClientPrivateJsonRPC::requestExtendedEvents(uint32_t sessionId, uint32_t extendedEvents) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    session->eventMask = extendedEvents;
+    updateEventInterest();
+    return TTS_OK;
+}
+
+void TTSClientPrivateJsonRPC::updateEventInterest() {
+    TextToSpeechService::Instance()->setEventInterest(this, m_sessions.eventInterest());
+}
+
+TTS_Error TTSClientPrivateJsonRPC::setResourcePriority(uint32_t sessionId, uint32_t priority) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    session->resourcePriority = priority;
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateJsonRPC::setPreemptiveSpeak(uint32_t sessionId, bool preemptive) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    session->preemptive = preemptive;
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateJsonRPC::setSpeechChunking(uint32_t sessionId, bool enable) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    session->chunked = enable;
     return TTS_OK;
 }
 
-TTS_Error TTSClientPrivateJsonRPC::speak(uint32_t sessionId, SpeechData& data) {
+TTS_Error TTSClientPrivateJsonRPC::setDuplicateSuppression(uint32_t sessionId, DuplicateSpeechPolicy policy, uint32_t windowMs) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    session->duplicates.configure(policy, windowMs);
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateJsonRPC::getDuplicateStats(uint32_t sessionId, DuplicateStats &stats) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    stats = session->duplicates.stats();
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateJsonRPC::setSpeakAhead(uint32_t sessionId, uint32_t depth) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    m_sessions.setSpeakAhead(session, depth);
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateJsonRPC::getSpeechEstimates(uint32_t sessionId, std::vector<SpeechEstimate> &estimates) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    estimates = m_sessions.estimates(session);
+    return TTS_OK;
+}
+
+TTS_Error TTSClientPrivateJsonRPC::speak(uint32_t sessionId, SpeechData& data, uint32_t *serviceSpeechId) {
     CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
-    UNUSED(sessionId);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
 
     if(!m_ttsEnabled) {
         TTSLOG_ERROR("TTS is disabled, can't speak");
@@ -190,44 +282,93 @@ TTS_Error TTSClientPrivateJsonRPC::speak(uint32_t sessionId, SpeechData& data) {
     }
 
     TextToSpeechService::Instance()->registerSpeechEventHandlers();
+    return m_sessions.speak(session, data, serviceSpeechId);
+}
 
-    m_lastSpeechId = 0;
-    JsonObject request, response;
-    request["text"] = data.text;
-    request["callsign"] = m_callsign;
-    if(!TextToSpeechService::Instance()->invoke("speak", request, response)) {
-        TTSLOG_ERROR("Coudn't speak, %d..Error code: %d", m_ttsEnabled,response["TTS_Status"].Number());
-        return TTS_FAIL;
+TTS_Error TTSClientPrivateJsonRPC::speakBatch(uint32_t sessionId, std::vector<SpeechData> &data, std::vector<TTS_Error> &results) {
+    results.assign(data.size(), TTS_FAIL);
+    CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
+
+    if(!m_ttsEnabled) {
+        TTSLOG_ERROR("TTS is disabled, can't speak");
+        results.assign(data.size(), TTS_NOT_ENABLED);
+        return TTS_NOT_ENABLED;
     }
 
-    if(response.HasLabel("speechid")) {
-        m_lastSpeechId = response["speechid"].Number();
-        bool success = m_requestedSpeeches.add(data.id, m_lastSpeechId);
-        TTSLOG_INFO("Requested speech with clientid-%d, serviceid-%d, is_duplicate_client_id=%d", data.id, m_lastSpeechId, !success);
-    } else {
-        TTSLOG_ERROR("Requested speech with clientid-%d, text-%s doesn't return valid serviceid", data.id, data.text.c_str());
+    TextToSpeechService::Instance()->registerSpeechEventHandlers();
+
+    if(!m_sessions.canBatch(session, data))
+        return m_sessions.speakEach(session, data, results);
+
+    std::vector<JsonObject> requests(data.size());
+    for(size_t i = 0; i < data.size(); i++) {
+        requests[i]["text"] = data[i].text;
+        requests[i]["callsign"] = m_callsign;
     }
 
-    return TTS_OK;
+    std::vector<JsonObject> responses;
+    std::vector<bool> succeeded;
+    TextToSpeechService::Instance()->invokeBatch("speak", requests, responses, succeeded);
+
+    TTS_Error ret = TTS_OK;
+    std::vector<SessionTable::Submission> submitted;
+    for(size_t i = 0; i < data.size(); i++) {
+        if(!succeeded[i]) {
+            TTSLOG_ERROR("Coudn't speak clientid-%d", data[i].id);
+            ret = TTS_FAIL;
+            continue;
+        }
+
+        results[i] = TTS_OK;
+        if(responses[i].HasLabel("speechid")) {
+            submitted.push_back({data[i], (uint32_t)responses[i]["speechid"].Number()});
+        } else {
+            TTSLOG_ERROR("Requested speech with clientid-%d, text-%s doesn't return valid serviceid", data[i].id, data[i].text.c_str());
+        }
+    }
+
+    size_t added = m_sessions.addSpeeches(session, submitted);
+    for(auto &speech : submitted)
+        TextToSpeechService::Instance()->registerSpeech(speech.serviceid, this);
+    TTSLOG_INFO("Requested %zu speeches in a batch, %zu accepted, %zu duplicate client ids", data.size(), submitted.size(), submitted.size() - added);
+
+    return ret;
+}
+
+TTS_Error TTSClientPrivateJsonRPC::speakStream(uint32_t sessionId, SpeechData& data, TextSource &source) {
+    CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
+
+    if(!m_ttsEnabled) {
+        TTSLOG_ERROR("TTS is disabled, can't speak");
+        return TTS_NOT_ENABLED;
+    }
+
+    TextToSpeechService::Instance()->registerSpeechEventHandlers();
+    return m_sessions.speakStream(session, data, source);
 }
 
 TTS_Error TTSClientPrivateJsonRPC::abort(uint32_t sessionId, bool clearPending) {
     CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
-    UNUSED(sessionId);
-    UNUSED(clearPending);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
+
+    if(clearPending)
+        m_sessions.clearHeld(session);
 
     if(!m_ttsEnabled) {
         TTSLOG_WARNING("TTS is disabled, nothing to abort");
         return TTS_OK;
     }
 
-    if(m_requestedSpeeches.empty() || !m_lastSpeechId) {
+    if(!session->states.hasPending() || !session->lastSpeechId) {
         TTSLOG_WARNING("No speech in progress");
         return TTS_OK;
     }
 
+    uint32_t speechid = session->lastSpeechId;
     JsonObject request, response;
-    request["speechid"] = m_lastSpeechId;
+    request["speechid"] = speechid;
     if(!TextToSpeechService::Instance()->invoke("cancel", request, response)) {
         TTSLOG_ERROR("Coudn't abort");
         return TTS_FAIL;
@@ -236,16 +377,21 @@ TTS_Error TTSClientPrivateJsonRPC::abort(uint32_t sessionId, bool clearPending)
     return TTS_OK;
 }
 
+TTS_Error TTSClientPrivateJsonRPC::withdraw(uint32_t sessionId, uint32_t serviceSpeechId) {
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_NO_SESSION_FOUND);
+    return m_sessions.withdraw(session, serviceSpeechId) ? TTS_OK : TTS_FAIL;
+}
+
 TTS_Error TTSClientPrivateJsonRPC::pause(uint32_t sessionId, uint32_t speechId) {
     CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
-    UNUSED(sessionId);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
 
     if(!m_ttsEnabled) {
         TTSLOG_WARNING("TTS is disabled, nothing to pause");
         return TTS_OK;
     }
 
-    uint32_t serviceid = m_requestedSpeeches.getServiceId(speechId);
+    uint32_t serviceid = session->speeches.getServiceId(speechId);
     if(!serviceid) {
         TTSLOG_WARNING("No speech in progress");
         return TTS_OK;
@@ -258,19 +404,21 @@ TTS_Error TTSClientPrivateJsonRPC::pause(uint32_t sessionId, uint32_t speechId)
         return TTS_FAIL;
     }
 
+    // The paused event may not be subscribed
+    session->states.update(speechId, SPEECH_IN_PROGRESS, SPEECH_PAUSED);
     return TTS_OK;
 }
 
 TTS_Error TTSClientPrivateJsonRPC::resume(uint32_t sessionId, uint32_t speechId) {
     CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
-    UNUSED(sessionId);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
 
     if(!m_ttsEnabled) {
         TTSLOG_WARNING("TTS is disabled, nothing to resume");
         return TTS_OK;
     }
 
-    uint32_t serviceid = m_requestedSpeeches.getServiceId(speechId);
+    uint32_t serviceid = session->speeches.getServiceId(speechId);
     if(!serviceid) {
         TTSLOG_WARNING("No speech in progress");
         return TTS_OK;
@@ -283,33 +431,50 @@ TTS_Error TTSClientPrivateJsonRPC::resume(uint32_t sessionId, uint32_t speechId)
         return TTS_FAIL;
     }
 
+    // The resumed event may not be subscribed
+    session->states.update(speechId, SPEECH_PAUSED, SPEECH_IN_PROGRESS);
     return TTS_OK;
 }
 
-bool TTSClientPrivateJsonRPC::isSpeaking(uint32_t sessionId) {
+bool TTSClientPrivateJsonRPC::isSpeaking(uint32_t sessionId, bool force) {
     CHECK_CONNECTION_RETURN_ON_FAIL(false);
-    UNUSED(sessionId);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, false);
 
-    if(m_requestedSpeeches.empty() || !m_lastSpeechId) {
+    bool speaking = false;
+    if(!force && session->states.isSpeaking(speaking))
+        return speaking;
+
+    if(session->speeches.empty() || !session->lastSpeechId) {
         TTSLOG_WARNING("No speech in progress");
         return false;
     }
 
+    uint32_t speechid = session->lastSpeechId;
     JsonObject request, response;
-    request["speechid"] = m_lastSpeechId;
+    request["speechid"] = speechid;
     if(!TextToSpeechService::Instance()->invoke("isspeaking", request, response)) {
         TTSLOG_ERROR("isspeaking query failed");
         return false;
     }
 
-    return response.HasLabel("speaking") ? response["speaking"].Boolean() : false;
+    speaking = response.HasLabel("speaking") ? response["speaking"].Boolean() : false;
+
+    // Speeches are served in order, nothing requested before the last one can be
+    // in progress either, so the table is accurate again
+    if(!speaking)
+        session->states.resync();
+
+    return speaking;
 }
 
-TTS_Error TTSClientPrivateJsonRPC::getSpeechState(uint32_t sessionId, uint32_t speechId, SpeechState &state) {
+TTS_Error TTSClientPrivateJsonRPC::getSpeechState(uint32_t sessionId, uint32_t speechId, SpeechState &state, bool force) {
     CHECK_CONNECTION_RETURN_ON_FAIL(TTS_FAIL);
-    UNUSED(sessionId);
+    GET_SESSION_RETURN_ON_FAIL(session, sessionId, TTS_FAIL);
 
-    uint32_t serviceid = m_requestedSpeeches.getServiceId(speechId);
+    if(!force && session->states.get(speechId, state))
+        return TTS_OK;
+
+    uint32_t serviceid = session->speeches.getServiceId(speechId);
     if(!serviceid) {
         TTSLOG_WARNING("No speech in progress");
         return TTS_OK;
@@ -322,12 +487,46 @@ TTS_Error TTSClientPrivateJsonRPC::getSpeechState(uint32_t sessionId, uint32_t s
         return TTS_FAIL;
     }
     state = response.HasLabel("speechstate") ? (SpeechState)response["speechstate"].Number() : SPEECH_NOT_FOUND;
+    session->states.set(speechId, state);
+
+    return TTS_OK;
+}
 
+TTS_Error TTSClientPrivateJsonRPC::submit(SpeechData &data, uint32_t &speechid) {
+    speechid = 0;
+    JsonObject request, response;
+    request["text"] = data.text;
+    request["callsign"] = m_callsign;
+    if(!TextToSpeechService::Instance()->invoke("speak", request, response)) {
+        TTSLOG_ERROR("Coudn't speak, %d..Error code: %d", m_ttsEnabled,response["TTS_Status"].Number());
+        return TTS_FAIL;
+    }
+
+    if(response.HasLabel("speechid")) {
+        speechid = response["speechid"].Number();
+        TextToSpeechService::Instance()->registerSpeech(speechid, this);
+    } else {
+        TTSLOG_ERROR("Requested speech with clientid-%d, text-%s doesn't return valid serviceid", data.id, data.text.c_str());
+    }
     return TTS_OK;
 }
 
+bool TTSClientPrivateJsonRPC::cancel(uint32_t speechid) {
+    JsonObject request, response;
+    request["speechid"] = speechid;
+    if(!TextToSpeechService::Instance()->invoke("cancel", request, response)) {
+        TTSLOG_ERROR("Coudn't cancel speech %u", speechid);
+        return false;
+    }
+    return true;
+}
+
 void TTSClientPrivateJsonRPC::onActivation()
 {
+    Configuration config;
+    if(getTTSConfiguration(config, true) == TTS_OK)
+        m_voiceCatalogue.prefetch({ config.language });
+
     if(m_connectionCallback) {
         TTSLOG_INFO("Got service connected event from TTS Manager for %p", this);
         m_connectionCallback->onTTSServerConnected();
@@ -336,8 +535,14 @@ void TTSClientPrivateJsonRPC::onActivation()
 
 void TTSClientPrivateJsonRPC::onDeactivation()
 {
-    m_lastSpeechId = 0;
     m_ttsEnabled = false;
+    m_configuration.invalidate();
+    m_voiceCatalogue.invalidate();
+    m_sessions.reset();
+    for(auto &session : m_sessions.sessions()) {
+        session->lastSpeechId = 0;
+        session->states.invalidate();
+    }
     if(m_connectionCallback) {
         TTSLOG_INFO("Got service disconnected event from TTS Manager for %p", this);
         m_connectionCallback->onTTSServerClosed();
@@ -346,7 +551,9 @@ void TTSClientPrivateJsonRPC::onDeactivation()
 
 void TTSClientPrivateJsonRPC::onTTSStateChange(bool enabled)
 {
-    m_lastSpeechId = 0;
+    m_sessions.reset();
+    for(auto &session : m_sessions.sessions())
+        session->lastSpeechId = 0;
     m_ttsEnabled = enabled;
     if(m_connectionCallback) {
         TTSLOG_INFO("Got tts_state_changed event from TTS Manager for %p", this);
@@ -356,6 +563,8 @@ void TTSClientPrivateJsonRPC::onTTSStateChange(bool enabled)
 
 void TTSClientPrivateJsonRPC::onVoiceChange(std::string voice)
 {
+    m_configuration.invalidate();
+    m_voiceCatalogue.invalidate();
     if(m_connectionCallback) {
         TTSLOG_INFO("Got voice_changed event from TTS Manager %p, new voice = %s", this, voice.c_str());
         m_connectionCallback->onVoiceChanged(voice);
@@ -363,76 +572,42 @@ void TTSClientPrivateJsonRPC::onVoiceChange(std::string voice)
 }
 void TTSClientPrivateJsonRPC::onSpeechStart(uint32_t serviceSpeechId)
 {
-    uint32_t clientSpeechId = m_requestedSpeeches.getClientId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        SpeechData data(clientSpeechId);
-        TTSLOG_INFO("Got started event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechStart(m_appId, DEFAULT_SESSION_ID, data);
-    }
+    m_sessions.dispatch(SessionTable::SpeechStart, serviceSpeechId);
 }
 
 void TTSClientPrivateJsonRPC::onSpeechPause(uint32_t serviceSpeechId)
 {
-    uint32_t clientSpeechId = m_requestedSpeeches.getClientId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got paused event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechPause(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::SpeechPause, serviceSpeechId);
 }
 
 void TTSClientPrivateJsonRPC::onSpeechResume(uint32_t serviceSpeechId)
 {
-    uint32_t clientSpeechId = m_requestedSpeeches.getClientId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got resumed event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechResume(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::SpeechResume, serviceSpeechId);
 }
 
 void TTSClientPrivateJsonRPC::onSpeechCancel(uint32_t serviceSpeechId)
 {
-    uint32_t clientSpeechId = m_requestedSpeeches.removeServiceId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got cancelled event from session %u, speech id %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechCancelled(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::SpeechCancel, serviceSpeechId);
 }
 
 void TTSClientPrivateJsonRPC::onSpeechInterrupt(uint32_t serviceSpeechId)
 {
-    uint32_t clientSpeechId = m_requestedSpeeches.removeServiceId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got interrupted event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechInterrupted(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::SpeechInterrupt, serviceSpeechId);
 }
 
 void TTSClientPrivateJsonRPC::onNetworkError(uint32_t serviceSpeechId)
 {
-    uint32_t clientSpeechId = m_requestedSpeeches.removeServiceId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got networkerror event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onNetworkError(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::NetworkError, serviceSpeechId);
 }
 
 void TTSClientPrivateJsonRPC::onPlaybackError(uint32_t serviceSpeechId)
 {
-    uint32_t clientSpeechId = m_requestedSpeeches.removeServiceId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        TTSLOG_INFO("Got playbackerror event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onPlaybackError(m_appId, DEFAULT_SESSION_ID, clientSpeechId);
-    }
+    m_sessions.dispatch(SessionTable::PlaybackError, serviceSpeechId);
 }
 
 void TTSClientPrivateJsonRPC::onSpeechComplete(uint32_t serviceSpeechId)
 {
-    uint32_t clientSpeechId = m_requestedSpeeches.removeServiceId(serviceSpeechId);
-    if(clientSpeechId && m_sessionCallback) {
-        SpeechData data(clientSpeechId);
-        TTSLOG_INFO("Got spoke event from session %u", DEFAULT_SESSION_ID);
-        m_sessionCallback->onSpeechComplete(m_appId, DEFAULT_SESSION_ID, data);
-    }
+    m_sessions.dispatch(SessionTable::SpeechComplete, serviceSpeechId);
 }
 
 } // namespace TTS
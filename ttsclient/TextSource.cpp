@@ -0,0 +1,120 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "TextSource.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace TTS {
+
+IteratorTextSource::IteratorTextSource(Next next) :
+    m_next(next),
+    m_offset(0),
+    m_done(false) {
+}
+
+size_t IteratorTextSource::read(char *buffer, size_t size) {
+    while(m_offset >= m_segment.size()) {
+        m_segment.clear();
+        m_offset = 0;
+        if(m_done || !m_next || !m_next(m_segment)) {
+            m_done = true;
+            return 0;
+        }
+    }
+
+    size_t length = std::min(size, m_segment.size() - m_offset);
+    memcpy(buffer, m_segment.data() + m_offset, length);
+    m_offset += length;
+    return length;
+}
+
+FdTextSource::FdTextSource(int fd) :
+    m_fd(fd) {
+}
+
+size_t FdTextSource::read(char *buffer, size_t size) {
+    while(1) {
+        ssize_t length = ::read(m_fd, buffer, size);
+        if(length >= 0)
+            return length;
+        if(errno != EINTR) {
+            TTSLOG_ERROR("Couldn't read the text from fd %d, error %d", m_fd, errno);
+            return 0;
+        }
+    }
+}
+
+MappedTextSource::MappedTextSource(const std::string &path) :
+    m_data(nullptr),
+    m_size(0),
+    m_offset(0),
+    m_released(0) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0) {
+        TTSLOG_ERROR("Couldn't open \"%s\", error %d", path.c_str(), errno);
+        return;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) == 0 && info.st_size > 0) {
+        void *data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(data != MAP_FAILED) {
+            m_data = (char*)data;
+            m_size = info.st_size;
+            madvise(m_data, m_size, MADV_SEQUENTIAL);
+        } else {
+            TTSLOG_ERROR("Couldn't map \"%s\", error %d", path.c_str(), errno);
+        }
+    }
+    close(fd);
+}
+
+MappedTextSource::~MappedTextSource() {
+    if(m_data)
+        munmap(m_data, m_size);
+}
+
+size_t MappedTextSource::read(char *buffer, size_t size) {
+    if(!m_data)
+        return 0;
+
+    size_t length = std::min(size, m_size - m_offset);
+    memcpy(buffer, m_data + m_offset, length);
+    m_offset += length;
+
+    // Whole pages behind the read offset are not needed anymore
+    static const size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t consumed = (m_offset / pageSize) * pageSize;
+    if(consumed > m_released) {
+        madvise(m_data + m_released, consumed - m_released, MADV_DONTNEED);
+        m_released = consumed;
+    }
+    return length;
+}
+
+} // namespace TTS
@@ -0,0 +1,84 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef _TTS_TEXT_SOURCE_H_
+#define _TTS_TEXT_SOURCE_H_
+
+#include <functional>
+#include <string>
+#include <cstddef>
+
+namespace TTS {
+
+// Text of a streamed speech (speakStream), pulled a segment at a time as the speech goes
+// on. read() copies up to "size" bytes into "buffer" and returns the count, 0 once the
+// text is over. It is called from the library's threads, never concurrently, until the
+// speech ends.
+class TextSource {
+public:
+    virtual ~TextSource() {}
+    virtual size_t read(char *buffer, size_t size) = 0;
+};
+
+// Pull iterator, "next" hands out the next segment and returns false once the text is over
+class IteratorTextSource : public TextSource {
+public:
+    using Next = std::function<bool (std::string &segment)>;
+
+    IteratorTextSource(Next next);
+    size_t read(char *buffer, size_t size) override;
+
+private:
+    Next m_next;
+    std::string m_segment;
+    size_t m_offset;
+    bool m_done;
+};
+
+// File, pipe or socket, the descriptor is left open
+class FdTextSource : public TextSource {
+public:
+    FdTextSource(int fd);
+    size_t read(char *buffer, size_t size) override;
+
+private:
+    int m_fd;
+};
+
+// Memory mapped file, the pages already read are dropped from the process as it goes
+class MappedTextSource : public TextSource {
+public:
+    MappedTextSource(const std::string &path);
+    ~MappedTextSource();
+
+    bool isValid() const { return m_data != nullptr; }
+    size_t read(char *buffer, size_t size) override;
+
+private:
+    MappedTextSource(const MappedTextSource&) = delete;
+    MappedTextSource& operator=(const MappedTextSource&) = delete;
+
+    char *m_data;
+    size_t m_size;
+    size_t m_offset;
+    size_t m_released;
+};
+
+} // namespace TTS
+
+#endif //_TTS_TEXT_SOURCE_H_
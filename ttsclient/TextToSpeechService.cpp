@@ -18,11 +18,14 @@
 */
 
 #include "TextToSpeechService.h"
+#include "Executor.h"
 #include "logger.h"
 
 namespace TTSThunderClient {
 
 #define TEXTTOSPEECH_CALLSIGN "org.rdk.TextToSpeech.1"
+#define MAX_BUFFERED_EVENTS 32
+#define SUBSCRIBE_RETRY_INTERVAL 1000
 
 TextToSpeechService *TextToSpeechService::Instance()
 {
@@ -34,9 +37,14 @@ TextToSpeechService::TextToSpeechService() :
     Service(TEXTTOSPEECH_CALLSIGN),
     m_initialized(false),
     m_registeredSpeechEventHandlers(false),
+    m_subscribedEvents(0),
+    m_retryPending(false),
     m_restartOnCrash(false),
     m_maxRestartAttempts(3),
-    m_duration(60)
+    m_duration(60),
+    m_pendingSubscriptions(0),
+    m_flushing(false),
+    m_subscriber(TTS::Executor::Blocking())
 {
     setSecurityTokenPayload("http://texttospeechclient");
 }
@@ -49,22 +57,34 @@ void TextToSpeechService::initialize(bool activateIfRequired)
 
     Service::initialize(activateIfRequired);
 
-    if(isActive() && m_remoteObject) {
+    if(isActive() && remoteObject()) {
         subscribe("onttsstatechanged", onTTSStateChange, this);
         subscribe("onvoicechanged", onVoiceChange, this);
     }
 
     m_initialized = true;
+    lock.unlock();
 
-    for(ClientList::iterator it = m_clients.begin(); it != m_clients.end(); ++it)
-        ((TextToSpeechService::Client*)(*it))->onTTSStateChange(false);
+    // The speech events are subscribed as soon as the service is up, not with the first speech
+    registerSpeechEventHandlers();
+
+    ClientList::Reader clients(m_clients);
+    clients.forEach([](Service::Client *client) {
+        ((TextToSpeechService::Client*)client)->onTTSStateChange(false);
+    });
 }
 
 void TextToSpeechService::uninitialize()
 {
     Service::uninitialize();
     m_initialized = false;
-    m_registeredSpeechEventHandlers = false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_registeredSpeechEventHandlers = false;
+    }
+    // Ahead of the updates of the next registration
+    m_subscriber.post([this]() { m_subscribedEvents = 0; });
 }
 
 bool TextToSpeechService::initialized()
@@ -74,17 +94,131 @@ bool TextToSpeechService::initialized()
 
 void TextToSpeechService::registerSpeechEventHandlers()
 {
-    if(isActive() && !m_registeredSpeechEventHandlers && m_remoteObject) {
+    if(isActive() && !m_registeredSpeechEventHandlers && remoteObject()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_registeredSpeechEventHandlers)
+            return;
+
         m_registeredSpeechEventHandlers = true;
-        subscribe("onspeechstart", onSpeechStart, this);
-        subscribe("onspeechpause", onSpeechPause, this);
-        subscribe("onspeechresume", onSpeechResume, this);
-        subscribe("onspeechcancelled", onSpeechCancel, this);
-        subscribe("onspeechinterrupted", onSpeechInterrupt, this);
-        subscribe("onnetworkerror", onNetworkError, this);
-        subscribe("onplaybackerror", onPlaybackError, this);
-        subscribe("onspeechcomplete", onSpeechComplete, this);
+
+        using Handler = void (*)(TextToSpeechService*, const JsonObject&);
+        static const std::pair<const char*, Handler> events[] = {
+            { "onspeechstart", onSpeechStart },
+            { "onspeechcancelled", onSpeechCancel },
+            { "onspeechinterrupted", onSpeechInterrupt },
+            { "onnetworkerror", onNetworkError },
+            { "onplaybackerror", onPlaybackError },
+            { "onspeechcomplete", onSpeechComplete }
+        };
+
+        {
+            std::lock_guard<std::mutex> bufferLock(m_bufferMutex);
+            m_pendingSubscriptions += sizeof(events) / sizeof(events[0]) + 1;
+        }
+
+        // Each subscription is a round trip, they are made concurrently on the
+        // executor's blocking lane so that neither the speeches nor the events wait for them
+        for(auto &event : events) {
+            TTS::Executor::Blocking().post([this, event]() {
+                subscribe(event.first, event.second, this);
+                onSubscribed();
+            });
+        }
+        m_subscriber.post([this]() {
+            updateSubscriptions();
+            onSubscribed();
+        });
+    }
+}
+
+bool TextToSpeechService::bufferEvent(EventType event, const JsonObject &params)
+{
+    std::lock_guard<std::mutex> lock(m_bufferMutex);
+    if(!m_pendingSubscriptions && !m_flushing)
+        return false;
+
+    if(m_bufferedEvents.size() >= MAX_BUFFERED_EVENTS) {
+        TTSLOG_WARNING("Event buffer is full, SpeechEvent-%d is delivered out of order", (int)event);
+        return false;
     }
+
+    m_bufferedEvents.emplace_back(event, params);
+    return true;
+}
+
+void TextToSpeechService::onSubscribed()
+{
+    std::unique_lock<std::mutex> lock(m_bufferMutex);
+    if(--m_pendingSubscriptions || m_flushing)
+        return;
+
+    // Events arriving meanwhile are queued behind the ones being flushed
+    m_flushing = true;
+    while(!m_bufferedEvents.empty()) {
+        auto event = std::move(m_bufferedEvents.front());
+        m_bufferedEvents.pop_front();
+        lock.unlock();
+        deliverEvent(event.first, event.second);
+        lock.lock();
+    }
+    m_flushing = false;
+}
+
+void TextToSpeechService::setEventInterest(Client *client, uint32_t events)
+{
+    if(!m_interest.set(client, events))
+        return;
+
+    // Each change is a round trip, the app doesn't wait for it
+    m_subscriber.post([this]() { updateSubscriptions(); });
+}
+
+void TextToSpeechService::updateSubscriptions()
+{
+    // Nothing to update until the speech events are subscribed, once the service is up
+    if(!m_registeredSpeechEventHandlers)
+        return;
+
+    uint32_t wanted = m_interest.wanted();
+    uint32_t added = wanted & ~m_subscribedEvents;
+    uint32_t removed = m_subscribedEvents & ~wanted;
+
+    if((added & TTS::EXT_EVENT_PAUSED) && subscribe("onspeechpause", onSpeechPause, this))
+        m_subscribedEvents |= TTS::EXT_EVENT_PAUSED;
+    if((added & TTS::EXT_EVENT_RESUMED) && subscribe("onspeechresume", onSpeechResume, this))
+        m_subscribedEvents |= TTS::EXT_EVENT_RESUMED;
+
+    // The failed ones are retried for as long as they are wanted
+    if((wanted & ~m_subscribedEvents) && !m_retryPending) {
+        TTSLOG_WARNING("Couldn't subscribe to the extended events 0x%x, retrying", wanted & ~m_subscribedEvents);
+        m_retryPending = true;
+        m_subscriber.postAfter(std::chrono::milliseconds(SUBSCRIBE_RETRY_INTERVAL), [this]() {
+            m_retryPending = false;
+            updateSubscriptions();
+        });
+    }
+
+    if(removed & TTS::EXT_EVENT_PAUSED) {
+        unsubscribe("onspeechpause");
+        m_subscribedEvents &= ~TTS::EXT_EVENT_PAUSED;
+    }
+    if(removed & TTS::EXT_EVENT_RESUMED) {
+        unsubscribe("onspeechresume");
+        m_subscribedEvents &= ~TTS::EXT_EVENT_RESUMED;
+    }
+}
+
+void TextToSpeechService::unregisterClient(Service::Client *client)
+{
+    // Forget the client's speeches first, their events are broadcast from now on
+    m_speechOwners.remove(dynamic_cast<TextToSpeechService::Client*>(client));
+    setEventInterest(dynamic_cast<TextToSpeechService::Client*>(client), 0);
+    Service::unregisterClient(client);
+}
+
+void TextToSpeechService::registerSpeech(uint32_t speechid, Client *client)
+{
+    m_speechOwners.add(speechid, client);
 }
 
 void TextToSpeechService::restartServiceOnCrash(bool flag, uint8_t maxattempts, uint16_t duration, bool ignoreManualDeactivation)
@@ -97,6 +231,16 @@ void TextToSpeechService::restartServiceOnCrash(bool flag, uint8_t maxattempts,
 }
 
 void TextToSpeechService::dispatchEvent(EventType event, const JsonObject &params)
+{
+    // Until all the speech events are subscribed, the clients could see a speech
+    // end before the events of a subscription still in progress
+    if(event >= SpeechStart && bufferEvent(event, params))
+        return;
+
+    deliverEvent(event, params);
+}
+
+void TextToSpeechService::deliverEvent(EventType event, const JsonObject &params)
 {
     int speechid = 0;
     bool enabled = false;
@@ -118,21 +262,33 @@ void TextToSpeechService::dispatchEvent(EventType event, const JsonObject &param
     }
 
     if(dispatch && initialized()) {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        for(ClientList::iterator it = m_clients.begin(); it != m_clients.end(); ++it) {
+        auto deliver = [&](TextToSpeechService::Client *client) {
             switch(event) {
-                case StateChange: ((TextToSpeechService::Client*)(*it))->onTTSStateChange(enabled); break;
-                case VoiceChange: ((TextToSpeechService::Client*)(*it))->onVoiceChange(voice); break;
-                case SpeechStart: ((TextToSpeechService::Client*)(*it))->onSpeechStart(speechid); break;
-                case SpeechPause: ((TextToSpeechService::Client*)(*it))->onSpeechPause(speechid); break;
-                case SpeechResume: ((TextToSpeechService::Client*)(*it))->onSpeechResume(speechid); break;
-                case SpeechCancel: ((TextToSpeechService::Client*)(*it))->onSpeechCancel(speechid); break;
-                case SpeechInterrupt: ((TextToSpeechService::Client*)(*it))->onSpeechInterrupt(speechid); break;
-                case NetworkError: ((TextToSpeechService::Client*)(*it))->onNetworkError(speechid); break;
-                case PlaybackError: ((TextToSpeechService::Client*)(*it))->onPlaybackError(speechid); break;
-                case SpeechComplete: ((TextToSpeechService::Client*)(*it))->onSpeechComplete(speechid); break;
+                case StateChange: client->onTTSStateChange(enabled); break;
+                case VoiceChange: client->onVoiceChange(voice); break;
+                case SpeechStart: client->onSpeechStart(speechid); break;
+                case SpeechPause: client->onSpeechPause(speechid); break;
+                case SpeechResume: client->onSpeechResume(speechid); break;
+                case SpeechCancel: client->onSpeechCancel(speechid); break;
+                case SpeechInterrupt: client->onSpeechInterrupt(speechid); break;
+                case NetworkError: client->onNetworkError(speechid); break;
+                case PlaybackError: client->onPlaybackError(speechid); break;
+                case SpeechComplete: client->onSpeechComplete(speechid); break;
             }
-        }
+        };
+
+        // The callbacks run on a snapshot of the client list, without any lock held.
+        // Speech events go to the requesting client only, the events after
+        // SpeechResume end the speech
+        ClientList::Reader clients(m_clients);
+        TextToSpeechService::Client *owner = nullptr;
+        if(event != StateChange && event != VoiceChange)
+            owner = m_speechOwners.owner(speechid, event > SpeechResume);
+
+        if(owner)
+            deliver(owner);
+        else
+            clients.forEach([&](Service::Client *client) { deliver((TextToSpeechService::Client*)client); });
     }
 }
 
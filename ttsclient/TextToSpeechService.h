@@ -20,6 +20,11 @@
 #define _TEXTTOSPEECH_SERVICES_H_
 
 #include "Service.h"
+#include "SpeechEventRouter.h"
+#include "EventInterest.h"
+
+#include <atomic>
+#include <deque>
 
 namespace TTSThunderClient {
 
@@ -61,7 +66,14 @@ public:
     void initialize(bool activateIfRequired = false) override;
     void uninitialize() override;
     bool initialized() override;
+    // Subscribes to the speech events in the background, it doesn't wait for them
     void registerSpeechEventHandlers();
+    void unregisterClient(Service::Client *client) override;
+    // Routes the events of "speechid" to "client" alone
+    void registerSpeech(uint32_t speechid, Client *client);
+    // Optional speech events (ExtendedEvents) "client" wants, the service subscribes
+    // to the ones some client wants and unsubscribes the others
+    void setEventInterest(Client *client, uint32_t events);
     void restartServiceOnCrash(bool flag, uint8_t maxAttempts = 3, uint16_t duration = 60, bool ignoreManualDeactivation = true);
 
 private:
@@ -74,6 +86,12 @@ private:
     virtual bool shouldExcludeRequestedDeactivations() { return m_ignoreManualDeactivation; }
 
     void dispatchEvent(EventType event, const JsonObject &params);
+    void deliverEvent(EventType event, const JsonObject &params);
+    // Speech events are kept back while the subscriptions are in progress
+    bool bufferEvent(EventType event, const JsonObject &params);
+    void onSubscribed();
+    // Runs on m_subscriber, a failed subscription is retried after a while
+    void updateSubscriptions();
     static void onTTSStateChange(TextToSpeechService *service, const JsonObject &params);
     static void onVoiceChange(TextToSpeechService *service, const JsonObject &params);
     static void onSpeechStart(TextToSpeechService *service, const JsonObject &params);
@@ -86,11 +104,25 @@ private:
     static void onSpeechComplete(TextToSpeechService *service, const JsonObject &params);
 
     bool m_initialized;
-    bool m_registeredSpeechEventHandlers;
+    // Checked without m_mutex on every speak, set under it
+    std::atomic<bool> m_registeredSpeechEventHandlers;
+    // Only used on m_subscriber
+    uint32_t m_subscribedEvents;
+    bool m_retryPending;
     bool m_restartOnCrash;
     bool m_ignoreManualDeactivation;
     uint8_t m_maxRestartAttempts;
     uint16_t m_duration;
+    TTS::SpeechEventRouter<Client> m_speechOwners;
+    TTS::EventInterest<Client> m_interest;
+
+    std::mutex m_bufferMutex;
+    std::deque<std::pair<EventType, JsonObject>> m_bufferedEvents;
+    uint32_t m_pendingSubscriptions;
+    bool m_flushing;
+
+    // Updates the optional subscriptions in order, off the app threads
+    TTS::Executor::Strand m_subscriber;
 };
 
 } // namespace TTSThunderClient
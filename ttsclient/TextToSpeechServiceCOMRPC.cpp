@@ -23,42 +23,82 @@
 namespace TTSThunderClient {
 
 #define TEXTTOSPEECH_CALLSIGN "org.rdk.TextToSpeech.1"
+#define RECONNECT_MIN_DELAY_MS 250
+#define RECONNECT_MAX_DELAY_MS 30000
+#define MAX_VOICE_NAMES 32
+// Events spilled past a full ring, before the next ones are dropped
+#define MAX_SPILLED_EVENTS 1024
+
+TextToSpeechServiceCOMRPC::AsyncWorker::AsyncWorker(TextToSpeechServiceCOMRPC *service) :
+    m_service(service),
+    m_scheduled(false),
+    m_spilling(false) {
+    m_spilled.reserve(MAX_SPILLED_EVENTS);
+    m_draining.reserve(MAX_SPILLED_EVENTS);
+}
 
 void TextToSpeechServiceCOMRPC::AsyncWorker::post(Task task) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_tasklist.push_back(task);
-    m_condition.notify_one();
+    m_strand.post([this, task] { task(m_service); });
+}
 
-    if(!m_thread) {
-        m_thread = new std::thread([this](void *) {
-            TTSLOG_VERBOSE("Started AsyncWorker thread");
-            while(1) {
-                std::unique_lock<std::mutex> lock(m_mutex);
-                m_condition.wait(lock, [this] { return (m_tasklist.size() > 0) || !m_running; });
+bool TextToSpeechServiceCOMRPC::AsyncWorker::postEvent(const EventRecord &record) {
+    // Once the ring overflowed the events go to the spill list until the drain caught
+    // up, so that they are still dispatched in order
+    if(m_spilling.load() || !m_events.push(record))
+        return false;
 
-                if(!m_running)
-                    break;
+    scheduleDrain();
+    return true;
+}
 
-                Task task = m_tasklist.front();
-                m_tasklist.pop_front();
-                m_mutex.unlock();
+bool TextToSpeechServiceCOMRPC::AsyncWorker::spillEvent(const EventRecord &record) {
+    {
+        std::lock_guard<std::mutex> lock(m_spillMutex);
+        if(m_spilled.size() >= MAX_SPILLED_EVENTS)
+            return false;
+        m_spilled.push_back(record);
+        m_spilling.store(true);
+    }
+    scheduleDrain();
+    return true;
+}
 
-                task(m_service);
-            }
-            TTSLOG_VERBOSE("Exited from AsyncWorker thread");
-        }, this);
+void TextToSpeechServiceCOMRPC::AsyncWorker::scheduleDrain() {
+    // Pairs with the drain clearing m_scheduled before it empties the ring, only
+    // the first event after that schedules another drain
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(!m_scheduled.exchange(true))
+        m_strand.post([this] { drainEvents(); });
+}
+
+void TextToSpeechServiceCOMRPC::AsyncWorker::drainEvents() {
+    m_scheduled.store(false);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // The whole batch of events queued since the drain was scheduled. The spilled
+    // events came after the ones in the ring when the spilling started
+    while(1) {
+        bool spilling = m_spilling.load();
+        EventRecord record;
+        while(m_events.pop(record))
+            m_service->dispatchEventOnWorker(record);
+
+        if(!spilling)
+            break;
+
+        {
+            std::lock_guard<std::mutex> lock(m_spillMutex);
+            m_draining.swap(m_spilled);
+            m_spilling.store(false);
+        }
+        for(auto &event : m_draining)
+            m_service->dispatchEventOnWorker(event);
+        m_draining.clear();
     }
 }
 
 void TextToSpeechServiceCOMRPC::AsyncWorker::cleanup() {
-    m_running = false;
-    if(!m_thread)
-        return;
-
-    m_condition.notify_one();
-    m_thread->join();
-    delete m_thread;
-    m_thread = nullptr;
+    m_strand.stop(true);
 }
 
 Core::NodeId getConnectionEndpoint()
@@ -78,13 +118,21 @@ TextToSpeechServiceCOMRPC *TextToSpeechServiceCOMRPC::Instance()
 
 TextToSpeechServiceCOMRPC::TextToSpeechServiceCOMRPC()
     : m_initialized(false)
-    , m_pendingInitAttempts(3)
     , m_registeredSpeechEventHandlers(false)
+    , m_connecting(false)
     , m_engine(Core::ProxyType<RPC::InvokeServerType<1, 0, 4>>::Create())
     , m_comChannel(Core::ProxyType<RPC::CommunicatorClient>::Create(getConnectionEndpoint(), Core::ProxyType<Core::IIPCServer>(m_engine)))
-    , m_remoteObject(nullptr)
     , m_notification(this)
     , m_worker(this)
+    , m_droppedEvents(0)
+    , m_spilledEvents(0)
+    , m_nextVoiceSlot(0)
+    , m_reconnecting(false)
+    , m_reconnectRunning(true)
+    , m_reconnectPending(false)
+    , m_reconnectDelay(RECONNECT_MIN_DELAY_MS)
+    , m_random(std::random_device()())
+    , m_reconnector(TTS::Executor::Blocking())
 {
 #if ((THUNDER_VERSION == 2) || ((THUNDER_VERSION >= 4) && (THUNDER_VERSION_MINOR == 2)))
     m_engine->Announcements(m_comChannel->Announcement());
@@ -103,70 +151,223 @@ bool TextToSpeechServiceCOMRPC::isActive(bool /*force*/)
 
 void TextToSpeechServiceCOMRPC::initialize(string callsign, bool /*activateIfRequired*/)
 {
-    std::unique_lock<std::mutex> lock(m_mutex);
+    // Every API call comes through here, once connected it doesn't lock
     if(initialized())
         return;
 
-    if(m_pendingInitAttempts > 0)
-        --m_pendingInitAttempts;
-    else
+    std::unique_lock<std::mutex> lock(m_connectionMutex);
+    if(initialized())
         return;
 
-    m_remoteObject = m_comChannel->Open<Exchange::ITextToSpeech>(TEXTTOSPEECH_CALLSIGN);
+    m_callsign = callsign;
 
-    if(!m_remoteObject) {
-        TTSLOG_ERROR("Couldn't connect to remote object \"%s\"", TEXTTOSPEECH_CALLSIGN);
+    // Only the very first attempt is made inline, after that the connection is
+    // owned by the reconnect attempts and API calls fail fast until one succeeds
+    if(m_reconnecting) {
+        scheduleReconnect();
         return;
     }
 
-    TTSLOG_INFO("Successfully connected to remote object \"%s\"", TEXTTOSPEECH_CALLSIGN);
-    m_remoteObject->AddRef();
-    m_initialized = true;
+    if(m_connecting)
+        return;
 
-    registerSpeechEventHandlers(callsign);
+    m_connecting = true;
+    lock.unlock();
+    bool connected = connect();
+    lock.lock();
+    m_connecting = false;
 
-    for(ClientList::iterator it = m_clients.begin(); it != m_clients.end(); ++it)
-        ((TextToSpeechServiceCOMRPC::Client*)(*it))->onTTSStateChange(false);
+    if(!connected)
+        scheduleReconnect();
 }
 
 void TextToSpeechServiceCOMRPC::uninitialize()
 {
+    {
+        std::unique_lock<std::mutex> lock(m_connectionMutex);
+        m_reconnectRunning = false;
+    }
+
+    // Drops the scheduled attempt, or waits for the one in progress
+    m_reconnector.stop(true);
+
     m_worker.cleanup();
+    if(m_droppedEvents || m_spilledEvents)
+        TTSLOG_WARNING("Event ring overflowed, %u events dropped, %u events spilled", m_droppedEvents.load(), m_spilledEvents.load());
+
+    std::unique_lock<std::mutex> lock(m_connectionMutex);
+    auto remote = remoteObject();
+    if(remote && m_registeredSpeechEventHandlers)
+        remote->Unregister(&m_notification);
+    disconnect();
+
+    if(m_engine.IsValid())
+        m_engine.Release();
+}
 
-    if(m_remoteObject) {
-        if(m_registeredSpeechEventHandlers)
-            m_remoteObject->Unregister(&m_notification);
+bool TextToSpeechServiceCOMRPC::connect()
+{
+    // Opening the channel blocks up to the COM-RPC timeout, so it is done on a
+    // channel of our own without m_connectionMutex and only the result is published
+    Core::ProxyType<RPC::CommunicatorClient> channel;
+    {
+        std::unique_lock<std::mutex> lock(m_connectionMutex);
+        channel = m_comChannel;
+        m_comChannel.Release();
+    }
 
-        m_remoteObject->Release();
-        m_remoteObject = nullptr;
+    if(!channel.IsValid()) {
+        channel = Core::ProxyType<RPC::CommunicatorClient>::Create(getConnectionEndpoint(), Core::ProxyType<Core::IIPCServer>(m_engine));
+#if ((THUNDER_VERSION == 2) || ((THUNDER_VERSION >= 4) && (THUNDER_VERSION_MINOR == 2)))
+        m_engine->Announcements(channel->Announcement());
+#endif
     }
-    m_registeredSpeechEventHandlers = false;
 
+    Exchange::ITextToSpeech *object = channel->Open<Exchange::ITextToSpeech>(TEXTTOSPEECH_CALLSIGN);
+
+    if(!object) {
+        TTSLOG_ERROR("Couldn't connect to remote object \"%s\"", TEXTTOSPEECH_CALLSIGN);
+        if(channel->IsOpen())
+            channel->Close(RPC::CommunicationTimeOut);
+        channel.Release();
+        return false;
+    }
+
+    TTSLOG_INFO("Successfully connected to remote object \"%s\"", TEXTTOSPEECH_CALLSIGN);
+    object->AddRef();
+
+    // The last reference, which may be held by an in-flight call, releases the proxy
+    std::shared_ptr<Exchange::ITextToSpeech> remote(object, [](Exchange::ITextToSpeech *object) {
+        object->Release();
+    });
+
+    string callsign;
+    {
+        std::unique_lock<std::mutex> lock(m_connectionMutex);
+        if(!m_reconnectRunning) {
+            // Uninitialized while opening
+            remote.reset();
+            channel->Close(RPC::CommunicationTimeOut);
+            channel.Release();
+            return false;
+        }
+
+        m_comChannel = channel;
+        std::atomic_store(&m_remoteObject, remote);
+        m_initialized.store(true, std::memory_order_release);
+        callsign = m_callsign;
+    }
+
+    registerSpeechEventHandlers(callsign);
+
+    // Clients are notified from the worker, they must not run on the connecting thread
+    dispatchEvent(EventType::StateChange, 0, false);
+
+    return true;
+}
+
+void TextToSpeechServiceCOMRPC::disconnect()
+{
+    m_initialized.store(false, std::memory_order_release);
+    std::atomic_store(&m_remoteObject, std::shared_ptr<Exchange::ITextToSpeech>());
+    m_registeredSpeechEventHandlers.store(false);
+
+    // A channel that has seen its peer go away can't be reused, a fresh one
+    // is created on the next connect()
     if(m_comChannel.IsValid()) {
         if(m_comChannel->IsOpen())
             m_comChannel->Close(RPC::CommunicationTimeOut);
         m_comChannel.Release();
     }
+}
 
-    if(m_engine.IsValid())
-        m_engine.Release();
+void TextToSpeechServiceCOMRPC::scheduleReconnect()
+{
+    if(!m_reconnectRunning || m_reconnectPending)
+        return;
+
+    m_reconnecting = true;
+    m_reconnectPending = true;
 
-    m_initialized = false;
+    // Randomize within the upper half of the backoff window, so that the clients
+    // of a restarted plugin don't all reconnect in lockstep
+    std::uniform_int_distribution<uint32_t> jitter(m_reconnectDelay / 2, m_reconnectDelay);
+    m_reconnector.postAfter(std::chrono::milliseconds(jitter(m_random)), [this] { reconnect(); });
+}
+
+void TextToSpeechServiceCOMRPC::reconnect()
+{
+    std::unique_lock<std::mutex> lock(m_connectionMutex);
+    if(!m_reconnectRunning)
+        return;
+
+    // A connection lost while connecting schedules the next attempt again
+    m_reconnectPending = false;
+    bool connected = initialized();
+    if(!connected) {
+        lock.unlock();
+        connected = connect();
+        lock.lock();
+    }
+
+    if(connected) {
+        m_reconnectDelay = RECONNECT_MIN_DELAY_MS;
+        m_worker.post([](TextToSpeechServiceCOMRPC *service) {
+            service->dispatchConnectionEvent(true);
+        });
+    } else {
+        m_reconnectDelay = std::min(m_reconnectDelay * 2, (uint32_t)RECONNECT_MAX_DELAY_MS);
+        TTSLOG_WARNING("Retrying connection to \"%s\" in about %u ms", TEXTTOSPEECH_CALLSIGN, m_reconnectDelay);
+        scheduleReconnect();
+    }
+}
+
+bool TextToSpeechServiceCOMRPC::handleResult(uint32_t ret)
+{
+    if(ret == Core::ERROR_CONNECTION_CLOSED || ret == Core::ERROR_UNAVAILABLE) {
+        std::unique_lock<std::mutex> lock(m_connectionMutex);
+        if(initialized()) {
+            TTSLOG_ERROR("Lost connection to remote object \"%s\", error=%u", TEXTTOSPEECH_CALLSIGN, ret);
+            disconnect();
+            scheduleReconnect();
+            m_worker.post([](TextToSpeechServiceCOMRPC *service) {
+                service->dispatchConnectionEvent(false);
+            });
+        }
+    }
+
+    return ret == Core::ERROR_NONE;
 }
 
 bool TextToSpeechServiceCOMRPC::initialized()
 {
-    return m_initialized;
+    return m_initialized.load(std::memory_order_acquire);
+}
+
+std::shared_ptr<Exchange::ITextToSpeech> TextToSpeechServiceCOMRPC::remoteObject() const
+{
+    if(!m_initialized.load(std::memory_order_acquire))
+        return nullptr;
+
+    return std::atomic_load(&m_remoteObject);
 }
 
 void TextToSpeechServiceCOMRPC::registerSpeechEventHandlers(string callsign)
 {
-    if(!m_registeredSpeechEventHandlers && m_remoteObject) {
-        m_registeredSpeechEventHandlers = true;
-        m_remoteObject->RegisterWithCallsign(callsign,&m_notification);
+    auto remote = remoteObject();
+    if(!remote)
+        return;
+
+    // Called by every client, only the first one after connecting registers
+    if(m_registeredSpeechEventHandlers.exchange(true))
+        return;
+
+    remote->RegisterWithCallsign(callsign,&m_notification);
+    {
+        std::lock_guard<std::mutex> lock(m_connectionMutex);
         m_callsign = callsign;
-        TTSLOG_INFO("register for notification with callsign %s",callsign.c_str());
     }
+    TTSLOG_INFO("register for notification with callsign %s",callsign.c_str());
 }
 
 void TextToSpeechServiceCOMRPC::registerClient(Client *client)
@@ -174,9 +375,7 @@ void TextToSpeechServiceCOMRPC::registerClient(Client *client)
     if(!client)
         return;
 
-    std::unique_lock<std::mutex> lock(m_mutex);
-    if(std::find(m_clients.begin(), m_clients.end(), client) == m_clients.end())
-        m_clients.push_back(client);
+    m_clients.add(client);
 }
 
 void TextToSpeechServiceCOMRPC::unregisterClient(Client *client)
@@ -184,182 +383,286 @@ void TextToSpeechServiceCOMRPC::unregisterClient(Client *client)
     if(!client)
         return;
 
-    std::unique_lock<std::mutex> lock(m_mutex);
-    ClientList::iterator it = std::find(m_clients.begin(), m_clients.end(), client);
-    if(it != m_clients.end())
-        m_clients.erase(it);
+    // Forget the client's speeches first, their events are broadcast from now on
+    m_speechOwners.remove(client);
+    m_interest.set(client, 0);
+    m_clients.remove(client);
+}
+
+void TextToSpeechServiceCOMRPC::registerSpeech(uint32_t speechid, Client *client)
+{
+    m_speechOwners.add(speechid, client);
+}
+
+void TextToSpeechServiceCOMRPC::setEventInterest(Client *client, uint32_t events)
+{
+    m_interest.set(client, events);
+}
+
+void TextToSpeechServiceCOMRPC::dispatchEvent(EventType event, uint32_t speechid, bool enabled, uint16_t voice)
+{
+    // One sink receives all the events, pause & resume are filtered here unless wanted
+    uint32_t wanted = m_interest.wanted();
+    if((event == SpeechPause && !(wanted & TTS::EXT_EVENT_PAUSED)) || (event == SpeechResume && !(wanted & TTS::EXT_EVENT_RESUMED)))
+        return;
+
+    EventRecord record = { event, speechid, enabled, voice };
+    if(m_worker.postEvent(record))
+        return;
+
+    // Ring is full. Pause & resume are dropped, the clients catch up with the next
+    // event of the speech. The others are spilled, in order, so that no speech misses
+    // its start (the scheduler tracks the playing speech by it) nor its end, and no
+    // state or voice change is lost. Once the spill list is full too they are dropped
+    if(event == SpeechPause || event == SpeechResume) {
+        m_droppedEvents++;
+        TTSLOG_WARNING("Event ring is full, dropped SpeechEvent-%d for servicespeecid=%u", (int)event, speechid);
+        return;
+    }
+
+    if(!m_worker.spillEvent(record)) {
+        m_droppedEvents++;
+        TTSLOG_ERROR("Event ring & spill list are full, dropped SpeechEvent-%d for servicespeecid=%u", (int)event, speechid);
+        return;
+    }
+    m_spilledEvents++;
+}
+
+uint16_t TextToSpeechServiceCOMRPC::internVoice(const std::string &voice)
+{
+    // Voice names are a handful. Past MAX_VOICE_NAMES the oldest slot is reused, the
+    // event still queued with it (if any) is long behind
+    std::lock_guard<std::mutex> lock(m_voiceMutex);
+    auto it = std::find(m_voices.begin(), m_voices.end(), voice);
+    if(it != m_voices.end())
+        return it - m_voices.begin();
+
+    if(m_voices.size() < MAX_VOICE_NAMES) {
+        m_voices.push_back(voice);
+        return m_voices.size() - 1;
+    }
+
+    uint16_t slot = m_nextVoiceSlot;
+    m_nextVoiceSlot = (m_nextVoiceSlot + 1) % MAX_VOICE_NAMES;
+    m_voices[slot] = voice;
+    return slot;
 }
 
-void TextToSpeechServiceCOMRPC::dispatchEvent(EventType event, const JsonValue &params)
+void TextToSpeechServiceCOMRPC::dispatchConnectionEvent(bool connected)
 {
-    m_worker.post([event, params](TextToSpeechServiceCOMRPC *service) {
-        service->dispatchEventOnWorker(event, params);
+    TTSLOG_INFO("%s, %s", __FUNCTION__, connected ? "connected" : "disconnected");
+
+    ClientList::Reader clients(m_clients);
+    clients.forEach([connected](Client *client) {
+        if(connected)
+            client->onActivation();
+        else
+            client->onDeactivation();
     });
 }
 
-void TextToSpeechServiceCOMRPC::dispatchEventOnWorker(EventType event, const JsonValue params)
+void TextToSpeechServiceCOMRPC::dispatchEventOnWorker(const EventRecord &record)
 {
+    EventType event = record.type;
     int speechid = 0;
     bool enabled = false;
     std::string voice;
     bool dispatch = true;
 
     if(event == StateChange) {
-        enabled = params.Boolean();
+        enabled = record.enabled;
         TTSLOG_INFO("%s(StateChange), state=%s", __FUNCTION__, enabled ? "enabled" : "disabled");
     } else if (event == VoiceChange) {
-        voice = params.String();
+        {
+            std::lock_guard<std::mutex> lock(m_voiceMutex);
+            voice = m_voices[record.voice];
+        }
         TTSLOG_INFO("%s(VoiceChange), voice=%s", __FUNCTION__, voice.c_str());
     } else {
-        speechid = params.Number();
+        speechid = record.speechid;
         TTSLOG_INFO("%s(SpeechEvent-%d), servicespeecid=%d", __FUNCTION__, (int)event, speechid);
     }
 
     if(dispatch && initialized()) {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        for(ClientList::iterator it = m_clients.begin(); it != m_clients.end(); ++it) {
+        auto deliver = [&](TextToSpeechServiceCOMRPC::Client *client) {
             switch(event) {
-                case StateChange: ((TextToSpeechServiceCOMRPC::Client*)(*it))->onTTSStateChange(enabled); break;
-                case VoiceChange: ((TextToSpeechServiceCOMRPC::Client*)(*it))->onVoiceChange(voice); break;
-                case SpeechStart: ((TextToSpeechServiceCOMRPC::Client*)(*it))->onSpeechStart(speechid); break;
-                case SpeechPause: ((TextToSpeechServiceCOMRPC::Client*)(*it))->onSpeechPause(speechid); break;
-                case SpeechResume: ((TextToSpeechServiceCOMRPC::Client*)(*it))->onSpeechResume(speechid); break;
-                case SpeechCancel: ((TextToSpeechServiceCOMRPC::Client*)(*it))->onSpeechCancel(speechid); break;
-                case SpeechInterrupt: ((TextToSpeechServiceCOMRPC::Client*)(*it))->onSpeechInterrupt(speechid); break;
-                case NetworkError: ((TextToSpeechServiceCOMRPC::Client*)(*it))->onNetworkError(speechid); break;
-                case PlaybackError: ((TextToSpeechServiceCOMRPC::Client*)(*it))->onPlaybackError(speechid); break;
-                case SpeechComplete: ((TextToSpeechServiceCOMRPC::Client*)(*it))->onSpeechComplete(speechid); break;
+                case StateChange: client->onTTSStateChange(enabled); break;
+                case VoiceChange: client->onVoiceChange(voice); break;
+                case SpeechStart: client->onSpeechStart(speechid); break;
+                case SpeechPause: client->onSpeechPause(speechid); break;
+                case SpeechResume: client->onSpeechResume(speechid); break;
+                case SpeechCancel: client->onSpeechCancel(speechid); break;
+                case SpeechInterrupt: client->onSpeechInterrupt(speechid); break;
+                case NetworkError: client->onNetworkError(speechid); break;
+                case PlaybackError: client->onPlaybackError(speechid); break;
+                case SpeechComplete: client->onSpeechComplete(speechid); break;
             }
-        }
+        };
+
+        // The callbacks run on a snapshot of the client list, without any lock held.
+        // Speech events go to the requesting client only, the events after
+        // SpeechResume end the speech
+        ClientList::Reader clients(m_clients);
+        TextToSpeechServiceCOMRPC::Client *owner = nullptr;
+        if(event != StateChange && event != VoiceChange)
+            owner = m_speechOwners.owner(speechid, event > SpeechResume);
+
+        if(owner)
+            deliver(owner);
+        else
+            clients.forEach(deliver);
     }
 }
 
 bool TextToSpeechServiceCOMRPC::setConfiguration(Exchange::ITextToSpeech::Configuration &ttsconfig)
 {
     uint32_t ret = Core::ERROR_NONE;
-    initialize(m_callsign);
     Exchange::ITextToSpeech::TTSErrorDetail status;
-    if(!isActive()) {
+    auto remote = remoteObject();
+    if(!remote) {
         TTSLOG_ERROR("Callsign \"%s\" is not active (or) COM channel is couldn't be opened", TEXTTOSPEECH_CALLSIGN);
         return false;
     }
 
-    ret = m_remoteObject->SetConfiguration(ttsconfig,status);
-    return ret == Core::ERROR_NONE;
+    ret = remote->SetConfiguration(ttsconfig,status);
+    return handleResult(ret);
 }
 
 bool TextToSpeechServiceCOMRPC::getSpeechState(uint32_t &speechid,  Exchange::ITextToSpeech::SpeechState &state)
 {
     uint32_t ret = Core::ERROR_NONE;
-    initialize(m_callsign);
-    if(!isActive()) {
+    auto remote = remoteObject();
+    if(!remote) {
         TTSLOG_ERROR("Callsign \"%s\" is not active (or) COM channel is couldn't be opened", TEXTTOSPEECH_CALLSIGN);
         return false;
     }
-    ret = m_remoteObject->GetSpeechState(speechid,state);
-    return ret == Core::ERROR_NONE;
+    ret = remote->GetSpeechState(speechid,state);
+    return handleResult(ret);
 }
 
 bool TextToSpeechServiceCOMRPC::isSpeaking(uint32_t &speechid,bool &isspeaking)
 {
     uint32_t ret = Core::ERROR_NONE;
     Exchange::ITextToSpeech::SpeechState istate;
-    initialize(m_callsign);
-    if(!isActive()) {
+    auto remote = remoteObject();
+    if(!remote) {
         TTSLOG_ERROR("Callsign \"%s\" is not active (or) COM channel is couldn't be opened", TEXTTOSPEECH_CALLSIGN);
         return false;
     }
-    ret = m_remoteObject->GetSpeechState(speechid,istate);
+    ret = remote->GetSpeechState(speechid,istate);
     isspeaking = (istate ==  Exchange::ITextToSpeech::SpeechState::SPEECH_IN_PROGRESS);
-    return ret == Core::ERROR_NONE;
+    return handleResult(ret);
 }
 
 bool  TextToSpeechServiceCOMRPC::isEnabled(bool &enable)
 {
     uint32_t ret = Core::ERROR_NONE;
-    initialize(m_callsign);
-    if(!isActive()) {
+    auto remote = remoteObject();
+    if(!remote) {
        TTSLOG_ERROR("Callsign \"%s\" is not active (or) COM channel is couldn't be opened", TEXTTOSPEECH_CALLSIGN);
        return false;
     }
-    ret = static_cast<const WPEFramework::Exchange::ITextToSpeech*>(m_remoteObject)->Enable(enable);
-    return ret == Core::ERROR_NONE;
+    ret = static_cast<const WPEFramework::Exchange::ITextToSpeech*>(remote.get())->Enable(enable);
+    return handleResult(ret);
 }
 
 bool  TextToSpeechServiceCOMRPC::enableTTS(bool &enable)
 {
     uint32_t ret = Core::ERROR_NONE;
-    initialize(m_callsign);
     const bool update = enable;
-    if(!isActive()) {
+    auto remote = remoteObject();
+    if(!remote) {
         TTSLOG_ERROR("Callsign \"%s\" is not active (or) COM channel is couldn't be opened", TEXTTOSPEECH_CALLSIGN);
         return false;
     }
-    ret = m_remoteObject->Enable(update);
-    return ret == Core::ERROR_NONE;
+    ret = remote->Enable(update);
+    return handleResult(ret);
 }
 
 bool TextToSpeechServiceCOMRPC::speak(string &callsign, string &text, uint32_t &speechid)
 {
     uint32_t ret = Core::ERROR_NONE;
     Exchange::ITextToSpeech::TTSErrorDetail status;
-    initialize(m_callsign);
-    if(!isActive()) {
+    auto remote = remoteObject();
+    if(!remote) {
         TTSLOG_ERROR("Callsign \"%s\" is not active (or) COM channel is couldn't be opened", TEXTTOSPEECH_CALLSIGN);
         return false;
     }
-    ret = m_remoteObject->Speak(callsign,text,speechid,status);
-    return ret == Core::ERROR_NONE;
+    ret = remote->Speak(callsign,text,speechid,status);
+    return handleResult(ret);
+}
+
+bool TextToSpeechServiceCOMRPC::speakBatch(string &callsign, std::vector<string> &texts, std::vector<uint32_t> &speechids, std::vector<bool> &results)
+{
+    bool success = true;
+    Exchange::ITextToSpeech::TTSErrorDetail status;
+    speechids.assign(texts.size(), 0);
+    results.assign(texts.size(), false);
+    auto remote = remoteObject();
+    if(!remote) {
+        TTSLOG_ERROR("Callsign \"%s\" is not active (or) COM channel is couldn't be opened", TEXTTOSPEECH_CALLSIGN);
+        return false;
+    }
+
+    // COM-RPC has no asynchronous invocation, the requests are issued
+    // back to back on the opened channel with a single connection check
+    for(size_t i = 0; i < texts.size(); i++) {
+        results[i] = handleResult(remote->Speak(callsign,texts[i],speechids[i],status));
+        success = success && results[i];
+        if(!isActive())
+            break;
+    }
+    return success;
 }
 
 bool TextToSpeechServiceCOMRPC::pause(uint32_t &speechid)
 {
     uint32_t ret = Core::ERROR_NONE;
     Exchange::ITextToSpeech::TTSErrorDetail status;
-    initialize(m_callsign);
-    if(!isActive()) {
+    auto remote = remoteObject();
+    if(!remote) {
         TTSLOG_ERROR("Callsign \"%s\" is not active (or) COM channel is couldn't be opened", TEXTTOSPEECH_CALLSIGN);
         return false;
     }
-    ret = m_remoteObject->Pause(speechid,status);
-    return ret == Core::ERROR_NONE;
+    ret = remote->Pause(speechid,status);
+    return handleResult(ret);
 }
 
 bool TextToSpeechServiceCOMRPC::resume(uint32_t &speechid)
 {
     uint32_t ret = Core::ERROR_NONE;
     Exchange::ITextToSpeech::TTSErrorDetail status;
-    initialize(m_callsign);
-     if(!isActive()) {
+    auto remote = remoteObject();
+    if(!remote) {
         TTSLOG_ERROR("Callsign \"%s\" is not active (or) COM channel is couldn't be opened", TEXTTOSPEECH_CALLSIGN);
         return false;
     }
-    ret = m_remoteObject->Resume(speechid,status);
-    return ret == Core::ERROR_NONE;
+    ret = remote->Resume(speechid,status);
+    return handleResult(ret);
 }
 
 bool TextToSpeechServiceCOMRPC::cancel(uint32_t &speechid)
 {
     uint32_t ret = Core::ERROR_NONE;
-    initialize(m_callsign);
-    if(!isActive()) {
+    auto remote = remoteObject();
+    if(!remote) {
         TTSLOG_ERROR("Callsign \"%s\" is not active (or) COM channel is couldn't be opened", TEXTTOSPEECH_CALLSIGN);
         return false;
     }
-    ret = m_remoteObject->Cancel(speechid);
-    return ret == Core::ERROR_NONE;
+    ret = remote->Cancel(speechid);
+    return handleResult(ret);
 }
 
 bool TextToSpeechServiceCOMRPC::getConfiguration(Exchange::ITextToSpeech::Configuration &ttsconfig)
 {
     uint32_t ret = Core::ERROR_NONE;
-    initialize(m_callsign);
-    if(!isActive()) {
+    auto remote = remoteObject();
+    if(!remote) {
         TTSLOG_ERROR("Callsign \"%s\" is not active (or) COM channel is couldn't be opened", TEXTTOSPEECH_CALLSIGN);
         return false;
     }
-    ret = m_remoteObject->GetConfiguration(ttsconfig);
-    return ret == Core::ERROR_NONE;
+    ret = remote->GetConfiguration(ttsconfig);
+    return handleResult(ret);
 }
 
 bool TextToSpeechServiceCOMRPC::listVoices(string &language,std::vector<std::string> &voices)
@@ -367,15 +670,16 @@ bool TextToSpeechServiceCOMRPC::listVoices(string &language,std::vector<std::str
     uint32_t ret = Core::ERROR_NONE;
     RPC::IStringIterator* voice = nullptr;
     string element;
-    if(!isActive()) {
+    auto remote = remoteObject();
+    if(!remote) {
         TTSLOG_ERROR("Callsign \"%s\" is not active (or) COM channel is couldn't be opened", TEXTTOSPEECH_CALLSIGN);
         return false;
     }
-    ret = m_remoteObject->ListVoices(language,voice);
-    while (voice->Next(element) == true) {
+    ret = remote->ListVoices(language,voice);
+    while (ret == Core::ERROR_NONE && voice && voice->Next(element) == true) {
         voices.push_back(element);
     }
-    return ret == Core::ERROR_NONE;
+    return handleResult(ret);
 }
 
 } // namespace TTSThunderClient
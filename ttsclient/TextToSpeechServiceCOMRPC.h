@@ -32,9 +32,13 @@
 
 #undef LOG
 #include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <random>
 #include <thread>
 #include <mutex>
 #include <list>
+#include <vector>
 
 #include <unistd.h>
 #include <sys/syscall.h>
@@ -50,6 +54,12 @@
 
 #include <interfaces/ITextToSpeech.h>
 
+#include "ClientSnapshotList.h"
+#include "EventRing.h"
+#include "Executor.h"
+#include "SpeechEventRouter.h"
+#include "EventInterest.h"
+
 namespace TTSThunderClient {
 
 
@@ -71,32 +81,52 @@ public:
         SpeechComplete
     };
 
+    // Notification as queued by the COM-RPC threads, "voice" is an index
+    // into the interned voice names
+    struct EventRecord {
+        EventType type;
+        uint32_t speechid;
+        bool enabled;
+        uint16_t voice;
+    };
+    using EventQueue = TTS::EventRing<EventRecord, 256>;
+
     // To activate & initialize on service crash
     // Those should be done on a separate thread other than
     // the callback thread
     struct AsyncWorker {
         using Task = std::function<void (TextToSpeechServiceCOMRPC *service)>;
-        using TaskList = std::list<Task>;
 
-        AsyncWorker(TextToSpeechServiceCOMRPC *service) : m_service(service), m_thread(nullptr), m_running(true) {}
+        AsyncWorker(TextToSpeechServiceCOMRPC *service);
         ~AsyncWorker() { cleanup(); }
 
         void post(Task task);
+        // Doesn't allocate nor lock, except to schedule a drain for the first event
+        // of a batch. Returns false when the ring is full or events are spilled
+        bool postEvent(const EventRecord &record);
+        // Queues the event after the ones in the ring, for when postEvent() failed.
+        // The spill list has a fixed capacity too, returns false when it is full
+        bool spillEvent(const EventRecord &record);
         void cleanup();
 
         private:
-        TextToSpeechServiceCOMRPC *m_service;
-        std::thread *m_thread;
+        void scheduleDrain();
+        void drainEvents();
 
-        bool m_running;
-        TaskList m_tasklist;
-        std::condition_variable m_condition;
-        std::mutex m_mutex;
-
-        friend class std::thread;
+        TextToSpeechServiceCOMRPC *m_service;
+        EventQueue m_events;
+        std::atomic<bool> m_scheduled;
+        std::atomic<bool> m_spilling;
+        // Both reserved up front, swapped by the drain
+        std::vector<EventRecord> m_spilled;
+        std::vector<EventRecord> m_draining;
+        std::mutex m_spillMutex;
+        TTS::Executor::Strand m_strand;
     };
 
     struct Client {
+        virtual void onActivation() {};
+        virtual void onDeactivation() {};
         virtual void onTTSStateChange(bool /*enabled*/) {};
         virtual void onVoiceChange(std::string /*voice*/) {};
         virtual void onSpeechStart(uint32_t /*speeechId*/) {};
@@ -109,7 +139,7 @@ public:
         virtual void onSpeechComplete(uint32_t /*speeechId*/) {};
     };
 
-    using ClientList = std::list<Client*>;
+    using ClientList = TTS::ClientSnapshotList<Client>;
 
     class Notification
         : public Exchange::ITextToSpeech::INotification
@@ -128,11 +158,11 @@ public:
         public:
             // ITextToSpeech::INotification
             virtual void Enabled(const bool state) override {
-                _parent.dispatchEvent(EventType::StateChange,JsonValue((bool)state));
+                _parent.dispatchEvent(EventType::StateChange, 0, state);
             }
 
             virtual void VoiceChanged(const string voice) override {
-                _parent.dispatchEvent(EventType::VoiceChange,JsonValue((std::string)voice));
+                _parent.dispatchEvent(EventType::VoiceChange, 0, false, _parent.internVoice(voice));
             }
 
             virtual void WillSpeak(const uint32_t ) {
@@ -140,31 +170,31 @@ public:
             }
 
             virtual void SpeechStart(const uint32_t speechid) override {
-                _parent.dispatchEvent(EventType::SpeechStart,JsonValue((int)speechid));
+                _parent.dispatchEvent(EventType::SpeechStart, speechid);
             }
 
             virtual void SpeechPause(const uint32_t speechid) override {
-                _parent.dispatchEvent(EventType::SpeechPause, JsonValue((int)speechid));
+                _parent.dispatchEvent(EventType::SpeechPause, speechid);
             }
 
             virtual void SpeechResume(const uint32_t speechid) override {
-                _parent.dispatchEvent(EventType::SpeechResume, JsonValue((int)speechid));
+                _parent.dispatchEvent(EventType::SpeechResume, speechid);
             }
 
             virtual void SpeechInterrupted(const uint32_t speechid) override {
-                _parent.dispatchEvent(EventType::SpeechInterrupt, JsonValue((int)speechid));
+                _parent.dispatchEvent(EventType::SpeechInterrupt, speechid);
             }
 
             virtual void NetworkError(const uint32_t speechid) override {
-                _parent.dispatchEvent(EventType::NetworkError, JsonValue((int)speechid));
+                _parent.dispatchEvent(EventType::NetworkError, speechid);
             }
 
             virtual void PlaybackError(const uint32_t speechid) override {
-                _parent.dispatchEvent(EventType::PlaybackError, JsonValue((int)speechid));
+                _parent.dispatchEvent(EventType::PlaybackError, speechid);
             }
 
             virtual void SpeechComplete(const uint32_t speechid) override {
-                _parent.dispatchEvent(EventType::SpeechComplete, JsonValue((int)speechid));
+                _parent.dispatchEvent(EventType::SpeechComplete, speechid);
             }
 
             BEGIN_INTERFACE_MAP(Notification)
@@ -189,6 +219,11 @@ public:
 
     void registerClient(Client *client);
     void unregisterClient(Client *client);
+    // Routes the events of "speechid" to "client" alone
+    void registerSpeech(uint32_t speechid, Client *client);
+    // Optional speech events (ExtendedEvents) "client" wants. The sink receives all the
+    // events, the unwanted ones are dropped there before reaching the worker
+    void setEventInterest(Client *client, uint32_t events);
 
     bool setConfiguration(Exchange::ITextToSpeech::Configuration &ttsconfig);
     bool getConfiguration(Exchange::ITextToSpeech::Configuration &ttsconfig);
@@ -198,6 +233,7 @@ public:
     bool isEnabled(bool &enable);
     bool enableTTS(bool &enable);
     bool speak(string &callsign,string &text,uint32_t &speechid);
+    bool speakBatch(string &callsign,std::vector<string> &texts,std::vector<uint32_t> &speechids,std::vector<bool> &results);
     bool pause(uint32_t &speechid);
     bool resume(uint32_t &speechid);
     bool cancel(uint32_t &speechid);
@@ -205,22 +241,52 @@ public:
 private:
     TextToSpeechServiceCOMRPC();
 
-    void dispatchEvent(EventType event, const JsonValue &params);
-    void dispatchEventOnWorker(EventType event, const JsonValue params);
-
-    bool m_initialized;
-    uint8_t m_pendingInitAttempts;
-    bool m_registeredSpeechEventHandlers;
+    void dispatchEvent(EventType event, uint32_t speechid = 0, bool enabled = false, uint16_t voice = 0);
+    void dispatchEventOnWorker(const EventRecord &record);
+    uint16_t internVoice(const std::string &voice);
+    void dispatchConnectionEvent(bool connected);
+    bool handleResult(uint32_t ret);
+
+    // Lock free, the connection may be swapped by a reconnect attempt at any time
+    // so callers work on their own reference of the remote object
+    std::shared_ptr<Exchange::ITextToSpeech> remoteObject() const;
+
+    // Connection handling, connect() takes m_connectionMutex itself to publish the
+    // channel it opened, the others expect it to be held
+    bool connect();
+    void disconnect();
+    void scheduleReconnect();
+    void reconnect();
+
+    std::atomic<bool> m_initialized;
+    std::atomic<bool> m_registeredSpeechEventHandlers;
+    bool m_connecting;
     ClientList m_clients;
-    std::mutex m_mutex;
+    TTS::SpeechEventRouter<Client> m_speechOwners;
+    TTS::EventInterest<Client> m_interest;
+    std::mutex m_connectionMutex;
     string m_callsign;
 
     Core::ProxyType<RPC::InvokeServerType<1, 0, 4>> m_engine;
     Core::ProxyType<RPC::CommunicatorClient> m_comChannel;
-    Exchange::ITextToSpeech *m_remoteObject { nullptr };
+    std::shared_ptr<Exchange::ITextToSpeech> m_remoteObject;
     Core::Sink<Notification> m_notification;
 
     AsyncWorker m_worker;
+    std::atomic<uint32_t> m_droppedEvents;
+    std::atomic<uint32_t> m_spilledEvents;
+    std::vector<std::string> m_voices;
+    uint16_t m_nextVoiceSlot;
+    std::mutex m_voiceMutex;
+
+    // Background reconnection with exponential backoff and jitter, the attempts
+    // are delayed jobs on the executor's blocking lane
+    bool m_reconnecting;
+    bool m_reconnectRunning;
+    bool m_reconnectPending;
+    uint32_t m_reconnectDelay;
+    std::mt19937 m_random;
+    TTS::Executor::Strand m_reconnector;
 
     friend class Notification;
 };
@@ -89,7 +89,7 @@ bool TextToSpeechServiceFirebolt::createFireboltInstance(const std::string& url)
             \"logLevel\": \"Info\",\
             \"workerPool\":{\
             \"queueSize\": 8,\
-            \"threadCount\": 3\
+            \"threadCount\": 1\
             },\
             \"wsUrl\": " +  url + "}";
     isConnected = false;
@@ -102,7 +102,8 @@ bool TextToSpeechServiceFirebolt::createFireboltInstance(const std::string& url)
 }
 
 TextToSpeechServiceFirebolt::TextToSpeechServiceFirebolt():
-    m_initialized(false)
+    m_initialized(false),
+    m_subscribedEvents(0)
     {
 }
 
@@ -130,19 +131,47 @@ void TextToSpeechServiceFirebolt::registerClient(Client* client){
     if(!client)
         return;
 
-    std::unique_lock<std::mutex> lock(m_mutex);
-    if(std::find(m_clients.begin(), m_clients.end(), client) == m_clients.end())
-        m_clients.push_back(client);
-
+    m_clients.add(client);
 }
 void TextToSpeechServiceFirebolt::unregisterClient(Client* client){
     if(!client)
         return;
 
+    // Forget the client's speeches first, their events are broadcast from now on
+    m_speechOwners.remove(client);
+    setEventInterest(client, 0);
+    m_clients.remove(client);
+}
+
+void TextToSpeechServiceFirebolt::registerSpeech(uint32_t speechid, Client* client){
+    m_speechOwners.add(speechid, client);
+}
+
+void TextToSpeechServiceFirebolt::setEventInterest(Client* client, uint32_t events){
+    if(!m_interest.set(client, events))
+        return;
+
     std::unique_lock<std::mutex> lock(m_mutex);
-    ClientList::iterator it = std::find(m_clients.begin(), m_clients.end(), client);
-    if(it != m_clients.end())
-        m_clients.erase(it);
+    updateSubscriptions();
+}
+
+void TextToSpeechServiceFirebolt::updateSubscriptions(){
+    if(!initialized())
+        return;
+
+    uint32_t wanted = m_interest.wanted();
+    uint32_t added = wanted & ~m_subscribedEvents;
+    uint32_t removed = m_subscribedEvents & ~wanted;
+
+    if(added & TTS::EXT_EVENT_PAUSED)
+        SubscribeVoiceGuidanceSettings("speechpause");
+    if(added & TTS::EXT_EVENT_RESUMED)
+        SubscribeVoiceGuidanceSettings("speechresume");
+    if(removed & TTS::EXT_EVENT_PAUSED)
+        UnsubscribeVoiceGuidanceSettings("speechpause");
+    if(removed & TTS::EXT_EVENT_RESUMED)
+        UnsubscribeVoiceGuidanceSettings("speechresume");
+    m_subscribedEvents = wanted;
 }
 
 bool TextToSpeechServiceFirebolt::initialized(){
@@ -243,10 +272,11 @@ bool TextToSpeechServiceFirebolt::subscribeEvents() {
    SubscribeVoiceGuidanceSettings("speechstart");
    SubscribeVoiceGuidanceSettings("speechcomplete");
    SubscribeVoiceGuidanceSettings("speechinterupped");
-   SubscribeVoiceGuidanceSettings("speechpause");
-   SubscribeVoiceGuidanceSettings("speechresume");
    SubscribeVoiceGuidanceSettings("ttsstatechange");
    SubscribeVoiceGuidanceSettings("voicechanged");
+   // Pause & resume only when some client wants them
+   m_subscribedEvents = 0;
+   updateSubscriptions();
    return true;
 }
 
@@ -256,14 +286,26 @@ bool TextToSpeechServiceFirebolt::unSubscribeEvents() {
     UnsubscribeVoiceGuidanceSettings("speechstart");
     UnsubscribeVoiceGuidanceSettings("speechcomplete");
     UnsubscribeVoiceGuidanceSettings("speechinterupped");
-    UnsubscribeVoiceGuidanceSettings("speechpause");
-    UnsubscribeVoiceGuidanceSettings("speechresume");
+    if(m_subscribedEvents & TTS::EXT_EVENT_PAUSED)
+        UnsubscribeVoiceGuidanceSettings("speechpause");
+    if(m_subscribedEvents & TTS::EXT_EVENT_RESUMED)
+        UnsubscribeVoiceGuidanceSettings("speechresume");
+    m_subscribedEvents = 0;
     UnsubscribeVoiceGuidanceSettings("ttsstatechange");
     UnsubscribeVoiceGuidanceSettings("voicechanged");
     return true;
 }
 
 void TextToSpeechServiceFirebolt::dispatchEvent(EventType event, const std::optional<int32_t>& speechId,const std::optional<bool>& ttsstatus,const std::optional<std::string>& voices)
+{
+    // The SDK threads only hand the events over, the clients are called in order
+    // from the library's shared executor
+    m_worker.post([this, event, speechId, ttsstatus, voices] {
+        dispatchEventOnWorker(event, speechId, ttsstatus, voices);
+    });
+}
+
+void TextToSpeechServiceFirebolt::dispatchEventOnWorker(EventType event, const std::optional<int32_t>& speechId,const std::optional<bool>& ttsstatus,const std::optional<std::string>& voices)
 {
     int speechid = 0;
     bool enabled = false;
@@ -281,21 +323,33 @@ void TextToSpeechServiceFirebolt::dispatchEvent(EventType event, const std::opti
         TTSLOG_INFO("%s(SpeechEvent-%d), servicespeecid=%d", __FUNCTION__, (int)event, speechid);
     }
 	    if(dispatch && initialized()) {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        for(ClientList::iterator it = m_clients.begin(); it != m_clients.end(); ++it) {
+        auto deliver = [&](TextToSpeechServiceFirebolt::Client *client) {
             switch(event) {
-                case StateChange: ((TextToSpeechServiceFirebolt::Client*)(*it))->onTTSStateChange(enabled); break;
-                case VoiceChange: ((TextToSpeechServiceFirebolt::Client*)(*it))->onVoiceChange(voice); break;
-                case SpeechStart: ((TextToSpeechServiceFirebolt::Client*)(*it))->onSpeechStart(speechid);break;
-                case SpeechPause: ((TextToSpeechServiceFirebolt::Client*)(*it))->onSpeechPause(speechid); break;
-                case SpeechResume: ((TextToSpeechServiceFirebolt::Client*)(*it))->onSpeechResume(speechid); break;
-                case SpeechCancel: ((TextToSpeechServiceFirebolt::Client*)(*it))->onSpeechCancel(speechid); break;
-                case SpeechInterrupt: ((TextToSpeechServiceFirebolt::Client*)(*it))->onSpeechInterrupt(speechid); break;
-                case NetworkError: ((TextToSpeechServiceFirebolt::Client*)(*it))->onNetworkError(speechid); break;
-                case PlaybackError: ((TextToSpeechServiceFirebolt::Client*)(*it))->onPlaybackError(speechid); break;
-                case SpeechComplete: ((TextToSpeechServiceFirebolt::Client*)(*it))->onSpeechComplete(speechid); break;
+                case StateChange: client->onTTSStateChange(enabled); break;
+                case VoiceChange: client->onVoiceChange(voice); break;
+                case SpeechStart: client->onSpeechStart(speechid);break;
+                case SpeechPause: client->onSpeechPause(speechid); break;
+                case SpeechResume: client->onSpeechResume(speechid); break;
+                case SpeechCancel: client->onSpeechCancel(speechid); break;
+                case SpeechInterrupt: client->onSpeechInterrupt(speechid); break;
+                case NetworkError: client->onNetworkError(speechid); break;
+                case PlaybackError: client->onPlaybackError(speechid); break;
+                case SpeechComplete: client->onSpeechComplete(speechid); break;
             }
-        }
+        };
+
+        // The callbacks run on a snapshot of the client list, without any lock held.
+        // Speech events go to the requesting client only, the events after
+        // SpeechResume end the speech
+        ClientList::Reader clients(m_clients);
+        TextToSpeechServiceFirebolt::Client *owner = nullptr;
+        if(event != StateChange && event != VoiceChange)
+            owner = m_speechOwners.owner(speechid, event > SpeechResume);
+
+        if(owner)
+            deliver(owner);
+        else
+            clients.forEach(deliver);
     }
 }
 
@@ -425,6 +479,30 @@ bool TextToSpeechServiceFirebolt::speak(std::string &callsign,std::string &text,
     return false;
 }
 
+bool TextToSpeechServiceFirebolt::speakBatch(std::string &callsign,std::vector<std::string> &texts,std::vector<uint32_t> &speechids,std::vector<bool> &results){
+    speechids.assign(texts.size(), 0);
+    results.assign(texts.size(), false);
+    if(!isActive()) {
+       TTSLOG_ERROR("Firebolt is not active (or) channel is couldn't be opened");
+       return false;
+    }
+    bool success = true;
+    for(size_t i = 0; i < texts.size(); i++) {
+        Firebolt::Error error = Firebolt::Error::None;
+        Firebolt::TextToSpeech::SpeechResponse speechResponse =
+            Firebolt::IFireboltAccessor::Instance().TextToSpeechInterface().speak(texts[i], callsign, &error);
+        if (error == Firebolt::Error::None && speechResponse.success) {
+            speechids[i] = speechResponse.speechid;
+            results[i] = true;
+        }
+        else {
+            TTSLOG_ERROR("speakBatch: Firebolt Error: \"%d\" ",static_cast<int>(error));
+            success = false;
+        }
+    }
+    return success;
+}
+
 bool TextToSpeechServiceFirebolt::pause(uint32_t &speechid) {
     if(!isActive()) {
        TTSLOG_ERROR("Firebolt is not active (or) channel is couldn't be opened");
@@ -25,6 +25,10 @@
 #include <mutex>
 #include <optional>
 #include <cassert>
+#include "ClientSnapshotList.h"
+#include "Executor.h"
+#include "SpeechEventRouter.h"
+#include "EventInterest.h"
 
 namespace TTSFirebolt{
 
@@ -57,7 +61,7 @@ public:
         virtual void onSpeechComplete(uint32_t /*speeechId*/) {};
     };
     
-    using ClientList = std::list<Client*>;
+    using ClientList = TTS::ClientSnapshotList<Client>;
     // Firebolt APIs
 
     // Notification for events
@@ -127,6 +131,11 @@ public:
   
     void registerClient(Client* client);
     void unregisterClient(Client* client);
+    // Routes the events of "speechid" to "client" alone
+    void registerSpeech(uint32_t speechid, Client* client);
+    // Optional speech events (ExtendedEvents) "client" wants, the service subscribes
+    // to the ones some client wants and unsubscribes the others
+    void setEventInterest(Client* client, uint32_t events);
 
     bool setConfiguration(Firebolt::TextToSpeech::TTSConfiguration &ttsconfig);
     bool getConfiguration(Firebolt::TextToSpeech::TTSConfiguration &ttsconfig);
@@ -136,6 +145,7 @@ public:
     bool isEnabled(bool &enable);
     //bool enableTTS(bool &enable);
     bool speak(std::string &callsign,std::string &text,uint32_t &speechid);
+    bool speakBatch(std::string &callsign,std::vector<std::string> &texts,std::vector<uint32_t> &speechids,std::vector<bool> &results);
     bool pause(uint32_t &speechid);
     bool resume(uint32_t &speechid);
     bool cancel(uint32_t &speechid);
@@ -155,6 +165,8 @@ private:
     bool destroyFireboltInstance();
     bool subscribeEvents();
     bool unSubscribeEvents();
+    // Expects m_mutex to be held
+    void updateSubscriptions();
     bool waitOnConnectionReady();
     bool initialized();
 
@@ -170,10 +182,14 @@ private:
     friend class onWillspeakNotification;
 
     void dispatchEvent(EventType event, const std::optional<int32_t>& speechid,const std::optional<bool>& ttsstatus,const std::optional<std::string>& voice);
+    void dispatchEventOnWorker(EventType event, const std::optional<int32_t>& speechid,const std::optional<bool>& ttsstatus,const std::optional<std::string>& voice);
 
     bool m_initialized;
+    uint32_t m_subscribedEvents;
         
     ClientList m_clients;
+    TTS::SpeechEventRouter<Client> m_speechOwners;
+    TTS::EventInterest<Client> m_interest;
     std::mutex m_mutex;
     static void connectionChanged(const bool, const Firebolt::Error);
     static bool isConnected;
@@ -186,6 +202,8 @@ private:
     static OnSpeechstartNotification onSpeechstartNotification;
     static OnTtsstatechangedNotification onTtsstatechangedNotification;
     static OnVoicechangedNotification onVoicechangedNotification;
+    // Last member, it is stopped before the ones its jobs use are destroyed
+    TTS::Executor::Strand m_worker;
 };
 
 }
@@ -0,0 +1,140 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "VoiceCatalogue.h"
+#include "logger.h"
+
+namespace TTS {
+
+VoiceCatalogue::VoiceCatalogue(Fetcher fetcher) :
+    m_fetcher(fetcher),
+    m_generation(0),
+    m_drainPosted(false),
+    m_strand(Executor::Blocking()) {
+}
+
+VoiceCatalogue::~VoiceCatalogue() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.clear();
+    }
+
+    // Waits for the fetch in progress, if any
+    m_strand.stop(true);
+}
+
+bool VoiceCatalogue::lookup(std::string &language, std::vector<std::string> &voices) {
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(find(language, voices))
+            return true;
+        generation = m_generation;
+    }
+
+    std::vector<std::string> fetched;
+    if(!m_fetcher(language, fetched))
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Don't let a fetch that raced with invalidate() repopulate the catalogue
+    if(generation == m_generation)
+        store(language, fetched);
+    voices.insert(voices.end(), fetched.begin(), fetched.end());
+    return true;
+}
+
+void VoiceCatalogue::prefetch(const std::vector<std::string> &languages) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.insert(m_pending.end(), languages.begin(), languages.end());
+    if(m_drainPosted || m_pending.empty())
+        return;
+
+    m_drainPosted = true;
+    m_strand.post([this] { drain(); });
+}
+
+void VoiceCatalogue::invalidate() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_arena.clear();
+    m_names.clear();
+    m_interned.clear();
+    m_entries.clear();
+    m_languages.clear();
+    m_pending.clear();
+    ++m_generation;
+}
+
+bool VoiceCatalogue::find(const std::string &language, std::vector<std::string> &voices) {
+    auto it = m_languages.find(language);
+    if(it == m_languages.end())
+        return false;
+
+    voices.reserve(voices.size() + it->second.count);
+    for(uint32_t i = it->second.first; i < it->second.first + it->second.count; i++) {
+        const Name &name = m_names[m_entries[i]];
+        voices.emplace_back(m_arena, name.offset, name.length);
+    }
+    return true;
+}
+
+void VoiceCatalogue::store(const std::string &language, const std::vector<std::string> &voices) {
+    if(m_languages.find(language) != m_languages.end())
+        return;
+
+    Range range = { (uint32_t)m_entries.size(), (uint32_t)voices.size() };
+    for(auto &voice : voices)
+        m_entries.push_back(intern(voice));
+    m_languages.emplace(language, range);
+    TTSLOG_VERBOSE("Cached %u voices for language \"%s\"", range.count, language.c_str());
+}
+
+uint32_t VoiceCatalogue::intern(const std::string &voice) {
+    size_t hash = std::hash<std::string>()(voice);
+    auto candidates = m_interned.equal_range(hash);
+    for(auto it = candidates.first; it != candidates.second; ++it) {
+        const Name &name = m_names[it->second];
+        if(m_arena.compare(name.offset, name.length, voice) == 0)
+            return it->second;
+    }
+
+    uint32_t id = m_names.size();
+    m_names.push_back({ (uint32_t)m_arena.size(), (uint32_t)voice.size() });
+    m_arena.append(voice);
+    m_interned.emplace(hash, id);
+    return id;
+}
+
+void VoiceCatalogue::drain() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_drainPosted = false;
+    while(m_pending.size() > 0) {
+        std::string language = m_pending.front();
+        m_pending.pop_front();
+        lock.unlock();
+
+        std::vector<std::string> voices;
+        if(!lookup(language, voices))
+            TTSLOG_WARNING("Couldn't prefetch voices for language \"%s\"", language.c_str());
+
+        lock.lock();
+    }
+}
+
+} // namespace TTS
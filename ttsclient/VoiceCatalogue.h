@@ -0,0 +1,88 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2019 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef _TTS_VOICE_CATALOGUE_H_
+#define _TTS_VOICE_CATALOGUE_H_
+
+#include "Executor.h"
+
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <list>
+
+namespace TTS {
+
+// Voices of the languages fetched so far, kept for the lifetime of the connection.
+// The voice names are interned into a single character arena and each language
+// refers to a contiguous range of interned ids, so a lookup is a memory copy.
+class VoiceCatalogue {
+public:
+    using Fetcher = std::function<bool (std::string &language, std::vector<std::string> &voices)>;
+
+    VoiceCatalogue(Fetcher fetcher);
+    ~VoiceCatalogue();
+
+    // Fetches (and keeps) the language's voices on the first lookup only
+    bool lookup(std::string &language, std::vector<std::string> &voices);
+
+    // Fetches the languages on the executor's blocking lane
+    void prefetch(const std::vector<std::string> &languages);
+
+    void invalidate();
+
+private:
+    VoiceCatalogue(const VoiceCatalogue&) = delete;
+    VoiceCatalogue& operator=(const VoiceCatalogue&) = delete;
+
+    struct Range {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    struct Name {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    bool find(const std::string &language, std::vector<std::string> &voices);
+    void store(const std::string &language, const std::vector<std::string> &voices);
+    uint32_t intern(const std::string &voice);
+    // Fetches the pending languages, runs on m_strand
+    void drain();
+
+    Fetcher m_fetcher;
+
+    std::string m_arena;
+    std::vector<Name> m_names;
+    std::unordered_multimap<size_t, uint32_t> m_interned;
+    std::vector<uint32_t> m_entries;
+    std::unordered_map<std::string, Range> m_languages;
+    uint32_t m_generation;
+    std::mutex m_mutex;
+
+    bool m_drainPosted;
+    std::list<std::string> m_pending;
+    Executor::Strand m_strand;
+};
+
+} // namespace TTS
+
+#endif //_TTS_VOICE_CATALOGUE_H_